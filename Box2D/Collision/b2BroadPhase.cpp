@@ -37,6 +37,22 @@ b2BroadPhase::~b2BroadPhase()
 	b2Free(m_pairBuffer);
 }
 
+void b2BroadPhase::Copy(const b2BroadPhase& broadPhase)
+{
+	m_tree.Copy(broadPhase.m_tree);
+	m_proxyCount = broadPhase.m_proxyCount;
+
+	// Keep the move buffer when it is large enough.
+	if (m_moveCapacity < broadPhase.m_moveCount)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = broadPhase.m_moveCapacity;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+	m_moveCount = broadPhase.m_moveCount;
+	memcpy(m_moveBuffer, broadPhase.m_moveBuffer, m_moveCount * sizeof(int32));
+}
+
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
 	int32 proxyId = m_tree.CreateProxy(aabb, userData);
@@ -62,6 +62,9 @@ public:
 	/// Get the fat AABB for a proxy.
 	const b2AABB& GetFatAABB(int32 proxyId) const;
 
+	/// Set the user data of a proxy.
+	void SetUserData(int32 proxyId, void* userData);
+
 	/// Get user data from a proxy. Returns NULL if the id is invalid.
 	void* GetUserData(int32 proxyId) const;
 
@@ -104,6 +107,10 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Make this broad-phase a copy of another one, with the same proxy ids
+	/// and the same proxies waiting for new pairs. The user data is copied as is.
+	void Copy(const b2BroadPhase& broadPhase);
+
 private:
 
 	friend class b2DynamicTree;
@@ -149,6 +156,11 @@ inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 	return m_tree.GetUserData(proxyId);
 }
 
+inline void b2BroadPhase::SetUserData(int32 proxyId, void* userData)
+{
+	m_tree.SetUserData(proxyId, userData);
+}
+
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
 	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
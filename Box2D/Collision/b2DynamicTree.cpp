@@ -776,3 +776,50 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+void b2DynamicTree::Copy(const b2DynamicTree& tree)
+{
+	// Keep the node pool when it is large enough.
+	if (m_nodeCapacity < tree.m_nodeCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodeCapacity = tree.m_nodeCapacity;
+		m_nodes = (b2TreeNode*)b2Alloc(m_nodeCapacity * sizeof(b2TreeNode));
+	}
+	memcpy(m_nodes, tree.m_nodes, tree.m_nodeCapacity * sizeof(b2TreeNode));
+
+	m_root = tree.m_root;
+	m_nodeCount = tree.m_nodeCount;
+	m_freeList = tree.m_freeList;
+	m_path = tree.m_path;
+	m_insertionCount = tree.m_insertionCount;
+
+	if (m_nodeCapacity == tree.m_nodeCapacity)
+	{
+		return;
+	}
+
+	// The spare nodes go to the end of the free list, so that nodes are
+	// allocated in the same order as when the copied tree grows its pool.
+	for (int32 i = tree.m_nodeCapacity; i < m_nodeCapacity - 1; ++i)
+	{
+		m_nodes[i].next = i + 1;
+		m_nodes[i].height = -1;
+	}
+	m_nodes[m_nodeCapacity-1].next = b2_nullNode;
+	m_nodes[m_nodeCapacity-1].height = -1;
+
+	if (m_freeList == b2_nullNode)
+	{
+		m_freeList = tree.m_nodeCapacity;
+	}
+	else
+	{
+		int32 last = m_freeList;
+		while (m_nodes[last].next != b2_nullNode)
+		{
+			last = m_nodes[last].next;
+		}
+		m_nodes[last].next = tree.m_nodeCapacity;
+	}
+}
@@ -253,9 +253,11 @@ struct b2SeparationFunction
 // by computing the largest time at which separation is maintained.
 void b2TimeOfImpact(b2TOIOutput* output, const b2TOIInput* input)
 {
+#ifdef B2_STATISTICS
 	b2Timer timer;
+#endif
 
-	++b2_toiCalls;
+	b2Statistic(++b2_toiCalls);
 
 	output->state = b2TOIOutput::e_unknown;
 	output->t = input->tMax;
@@ -422,7 +424,7 @@ void b2TimeOfImpact(b2TOIOutput* output, const b2TOIInput* input)
 				}
 
 				++rootIterCount;
-				++b2_toiRootIters;
+				b2Statistic(++b2_toiRootIters);
 
 				float32 s = fcn.Evaluate(indexA, indexB, t);
 
@@ -451,7 +453,7 @@ void b2TimeOfImpact(b2TOIOutput* output, const b2TOIInput* input)
 				}
 			}
 
-			b2_toiMaxRootIters = b2Max(b2_toiMaxRootIters, rootIterCount);
+			b2Statistic(b2_toiMaxRootIters = b2Max(b2_toiMaxRootIters, rootIterCount));
 
 			++pushBackIter;
 
@@ -462,7 +464,7 @@ void b2TimeOfImpact(b2TOIOutput* output, const b2TOIInput* input)
 		}
 
 		++iter;
-		++b2_toiIters;
+		b2Statistic(++b2_toiIters);
 
 		if (done)
 		{
@@ -478,9 +480,11 @@ void b2TimeOfImpact(b2TOIOutput* output, const b2TOIInput* input)
 		}
 	}
 
-	b2_toiMaxIters = b2Max(b2_toiMaxIters, iter);
+	b2Statistic(b2_toiMaxIters = b2Max(b2_toiMaxIters, iter));
 
+#ifdef B2_STATISTICS
 	float32 time = timer.GetMilliseconds();
 	b2_toiMaxTime = b2Max(b2_toiMaxTime, time);
 	b2_toiTime += time;
+#endif
 }
@@ -26,6 +26,15 @@
 #define B2_NOT_USED(x) ((void)(x))
 #define b2Assert(A) assert(A)
 
+/// The GJK and TOI statistics shown by the testbed are process globals,
+/// which worlds stepping on several threads at once would race on. They are
+/// only gathered when B2_STATISTICS is defined.
+#ifdef B2_STATISTICS
+#define b2Statistic(A) A
+#else
+#define b2Statistic(A)
+#endif
+
 typedef signed char	int8;
 typedef signed short int16;
 typedef signed int int32;
@@ -66,13 +66,20 @@ void b2Contact::AddType(b2ContactCreateFcn* createFcn, b2ContactDestroyFcn* dest
 	}
 }
 
-b2Contact* b2Contact::Create(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB, b2BlockAllocator* allocator)
+// The registers are filled when the library is loaded rather than by the
+// first contact, since worlds may be stepped on several threads at once.
+static struct b2ContactRegistersInitializer
 {
-	if (s_initialized == false)
+	b2ContactRegistersInitializer()
 	{
-		InitializeRegisters();
-		s_initialized = true;
+		b2Contact::InitializeRegisters();
+		b2Contact::s_initialized = true;
 	}
+} s_contactRegistersInitializer;
+
+b2Contact* b2Contact::Create(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB, b2BlockAllocator* allocator)
+{
+	b2Assert(s_initialized == true);
 
 	b2Shape::Type type1 = fixtureA->GetType();
 	b2Shape::Type type2 = fixtureB->GetType();
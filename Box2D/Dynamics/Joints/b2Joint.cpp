@@ -180,6 +180,265 @@ void b2Joint::Destroy(b2Joint* joint, b2BlockAllocator* allocator)
 	}
 }
 
+b2Joint* b2Joint::Clone(const b2Joint* joint, b2BlockAllocator* allocator)
+{
+	b2Joint* clone = NULL;
+
+	switch (joint->m_type)
+	{
+	case e_distanceJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2DistanceJoint));
+			clone = new (mem) b2DistanceJoint(*static_cast<const b2DistanceJoint*>(joint));
+		}
+		break;
+
+	case e_mouseJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2MouseJoint));
+			clone = new (mem) b2MouseJoint(*static_cast<const b2MouseJoint*>(joint));
+		}
+		break;
+
+	case e_prismaticJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2PrismaticJoint));
+			clone = new (mem) b2PrismaticJoint(*static_cast<const b2PrismaticJoint*>(joint));
+		}
+		break;
+
+	case e_revoluteJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2RevoluteJoint));
+			clone = new (mem) b2RevoluteJoint(*static_cast<const b2RevoluteJoint*>(joint));
+		}
+		break;
+
+	case e_pulleyJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2PulleyJoint));
+			clone = new (mem) b2PulleyJoint(*static_cast<const b2PulleyJoint*>(joint));
+		}
+		break;
+
+	case e_gearJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2GearJoint));
+			clone = new (mem) b2GearJoint(*static_cast<const b2GearJoint*>(joint));
+		}
+		break;
+
+	case e_wheelJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2WheelJoint));
+			clone = new (mem) b2WheelJoint(*static_cast<const b2WheelJoint*>(joint));
+		}
+		break;
+
+	case e_weldJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2WeldJoint));
+			clone = new (mem) b2WeldJoint(*static_cast<const b2WeldJoint*>(joint));
+		}
+		break;
+
+	case e_frictionJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2FrictionJoint));
+			clone = new (mem) b2FrictionJoint(*static_cast<const b2FrictionJoint*>(joint));
+		}
+		break;
+
+	case e_ropeJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2RopeJoint));
+			clone = new (mem) b2RopeJoint(*static_cast<const b2RopeJoint*>(joint));
+		}
+		break;
+
+	case e_motorJoint:
+		{
+			void* mem = allocator->Allocate(sizeof(b2MotorJoint));
+			clone = new (mem) b2MotorJoint(*static_cast<const b2MotorJoint*>(joint));
+		}
+		break;
+
+	default:
+		b2Assert(false);
+		break;
+	}
+
+	return clone;
+}
+
+void b2Joint::GetSolverState(const b2Joint* joint, b2JointSolverState* state)
+{
+	state->impulse.SetZero();
+	state->motorImpulse = 0.0f;
+	state->springImpulse = 0.0f;
+	state->limitState = e_inactiveLimit;
+
+	switch (joint->m_type)
+	{
+	case e_distanceJoint:
+		state->impulse.x = static_cast<const b2DistanceJoint*>(joint)->m_impulse;
+		break;
+
+	case e_mouseJoint:
+		{
+			const b2MouseJoint* j = static_cast<const b2MouseJoint*>(joint);
+			state->impulse.Set(j->m_impulse.x, j->m_impulse.y, 0.0f);
+		}
+		break;
+
+	case e_prismaticJoint:
+		{
+			const b2PrismaticJoint* j = static_cast<const b2PrismaticJoint*>(joint);
+			state->impulse = j->m_impulse;
+			state->motorImpulse = j->m_motorImpulse;
+			state->limitState = j->m_limitState;
+		}
+		break;
+
+	case e_revoluteJoint:
+		{
+			const b2RevoluteJoint* j = static_cast<const b2RevoluteJoint*>(joint);
+			state->impulse = j->m_impulse;
+			state->motorImpulse = j->m_motorImpulse;
+			state->limitState = j->m_limitState;
+		}
+		break;
+
+	case e_pulleyJoint:
+		state->impulse.x = static_cast<const b2PulleyJoint*>(joint)->m_impulse;
+		break;
+
+	case e_gearJoint:
+		state->impulse.x = static_cast<const b2GearJoint*>(joint)->m_impulse;
+		break;
+
+	case e_wheelJoint:
+		{
+			const b2WheelJoint* j = static_cast<const b2WheelJoint*>(joint);
+			state->impulse.x = j->m_impulse;
+			state->motorImpulse = j->m_motorImpulse;
+			state->springImpulse = j->m_springImpulse;
+		}
+		break;
+
+	case e_weldJoint:
+		state->impulse = static_cast<const b2WeldJoint*>(joint)->m_impulse;
+		break;
+
+	case e_frictionJoint:
+		{
+			const b2FrictionJoint* j = static_cast<const b2FrictionJoint*>(joint);
+			state->impulse.Set(j->m_linearImpulse.x, j->m_linearImpulse.y, j->m_angularImpulse);
+		}
+		break;
+
+	case e_ropeJoint:
+		{
+			const b2RopeJoint* j = static_cast<const b2RopeJoint*>(joint);
+			state->impulse.x = j->m_impulse;
+			state->limitState = j->m_state;
+		}
+		break;
+
+	case e_motorJoint:
+		{
+			const b2MotorJoint* j = static_cast<const b2MotorJoint*>(joint);
+			state->impulse.Set(j->m_linearImpulse.x, j->m_linearImpulse.y, j->m_angularImpulse);
+		}
+		break;
+
+	default:
+		b2Assert(false);
+		break;
+	}
+}
+
+void b2Joint::SetSolverState(b2Joint* joint, const b2JointSolverState& state)
+{
+	switch (joint->m_type)
+	{
+	case e_distanceJoint:
+		static_cast<b2DistanceJoint*>(joint)->m_impulse = state.impulse.x;
+		break;
+
+	case e_mouseJoint:
+		static_cast<b2MouseJoint*>(joint)->m_impulse.Set(state.impulse.x, state.impulse.y);
+		break;
+
+	case e_prismaticJoint:
+		{
+			b2PrismaticJoint* j = static_cast<b2PrismaticJoint*>(joint);
+			j->m_impulse = state.impulse;
+			j->m_motorImpulse = state.motorImpulse;
+			j->m_limitState = static_cast<b2LimitState>(state.limitState);
+		}
+		break;
+
+	case e_revoluteJoint:
+		{
+			b2RevoluteJoint* j = static_cast<b2RevoluteJoint*>(joint);
+			j->m_impulse = state.impulse;
+			j->m_motorImpulse = state.motorImpulse;
+			j->m_limitState = static_cast<b2LimitState>(state.limitState);
+		}
+		break;
+
+	case e_pulleyJoint:
+		static_cast<b2PulleyJoint*>(joint)->m_impulse = state.impulse.x;
+		break;
+
+	case e_gearJoint:
+		static_cast<b2GearJoint*>(joint)->m_impulse = state.impulse.x;
+		break;
+
+	case e_wheelJoint:
+		{
+			b2WheelJoint* j = static_cast<b2WheelJoint*>(joint);
+			j->m_impulse = state.impulse.x;
+			j->m_motorImpulse = state.motorImpulse;
+			j->m_springImpulse = state.springImpulse;
+		}
+		break;
+
+	case e_weldJoint:
+		static_cast<b2WeldJoint*>(joint)->m_impulse = state.impulse;
+		break;
+
+	case e_frictionJoint:
+		{
+			b2FrictionJoint* j = static_cast<b2FrictionJoint*>(joint);
+			j->m_linearImpulse.Set(state.impulse.x, state.impulse.y);
+			j->m_angularImpulse = state.impulse.z;
+		}
+		break;
+
+	case e_ropeJoint:
+		{
+			b2RopeJoint* j = static_cast<b2RopeJoint*>(joint);
+			j->m_impulse = state.impulse.x;
+			j->m_state = static_cast<b2LimitState>(state.limitState);
+		}
+		break;
+
+	case e_motorJoint:
+		{
+			b2MotorJoint* j = static_cast<b2MotorJoint*>(joint);
+			j->m_linearImpulse.Set(state.impulse.x, state.impulse.y);
+			j->m_angularImpulse = state.impulse.z;
+		}
+		break;
+
+	default:
+		b2Assert(false);
+		break;
+	}
+}
+
 b2Joint::b2Joint(const b2JointDef* def)
 {
 	b2Assert(def->bodyA != def->bodyB);
@@ -70,6 +70,17 @@ struct b2JointEdge
 	b2JointEdge* next;		///< the next joint edge in the body's joint list
 };
 
+/// What the solver carries over from one time step to the next for a joint:
+/// its warm starting impulses and the state of its limit. Joints use the
+/// fields they need, see b2World::SaveState.
+struct b2JointSolverState
+{
+	b2Vec3 impulse;
+	float32 motorImpulse;
+	float32 springImpulse;
+	int32 limitState;
+};
+
 /// Joint definitions are used to construct joints.
 struct b2JointDef
 {
@@ -158,6 +169,15 @@ protected:
 	static b2Joint* Create(const b2JointDef* def, b2BlockAllocator* allocator);
 	static void Destroy(b2Joint* joint, b2BlockAllocator* allocator);
 
+	// Copies the joint, including its warm starting impulses. The copy still
+	// refers to the bodies and joints of the original.
+	static b2Joint* Clone(const b2Joint* joint, b2BlockAllocator* allocator);
+
+	// Gets and sets the impulses and limit state of the joint, leaving its
+	// parameters and bodies alone.
+	static void GetSolverState(const b2Joint* joint, b2JointSolverState* state);
+	static void SetSolverState(b2Joint* joint, const b2JointSolverState& state);
+
 	b2Joint(const b2JointDef* def);
 	virtual ~b2Joint() {}
 
@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <algorithm>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
@@ -32,6 +33,14 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
+	m_deterministic = false;
+	m_sortBuffer = NULL;
+	m_sortCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_sortBuffer);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -171,7 +180,162 @@ void b2ContactManager::Collide()
 
 void b2ContactManager::FindNewContacts()
 {
+	int32 oldCount = m_contactCount;
+
 	m_broadPhase.UpdatePairs(this);
+
+	// New contacts are at the front of the list.
+	if (m_deterministic && m_contactCount > oldCount)
+	{
+		SortContacts(m_contactCount - oldCount);
+	}
+}
+
+bool b2ContactManager::LessThan(const b2Contact* a, const b2Contact* b)
+{
+	uint32 keyA[4] = { a->m_fixtureA->m_order, (uint32)a->m_indexA, a->m_fixtureB->m_order, (uint32)a->m_indexB };
+	uint32 keyB[4] = { b->m_fixtureA->m_order, (uint32)b->m_indexA, b->m_fixtureB->m_order, (uint32)b->m_indexB };
+
+	// The shape types may have swapped the fixtures of a contact.
+	if (keyA[2] < keyA[0] || (keyA[2] == keyA[0] && keyA[3] < keyA[1]))
+	{
+		b2Swap(keyA[0], keyA[2]);
+		b2Swap(keyA[1], keyA[3]);
+	}
+
+	if (keyB[2] < keyB[0] || (keyB[2] == keyB[0] && keyB[3] < keyB[1]))
+	{
+		b2Swap(keyB[0], keyB[2]);
+		b2Swap(keyB[1], keyB[3]);
+	}
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (keyA[i] != keyB[i])
+		{
+			return keyA[i] < keyB[i];
+		}
+	}
+
+	return false;
+}
+
+static void b2RemoveEdge(b2ContactEdge*& list, b2ContactEdge* edge)
+{
+	if (edge->prev)
+	{
+		edge->prev->next = edge->next;
+	}
+
+	if (edge->next)
+	{
+		edge->next->prev = edge->prev;
+	}
+
+	if (edge == list)
+	{
+		list = edge->next;
+	}
+}
+
+static void b2InsertEdge(b2ContactEdge*& list, b2ContactEdge* edge)
+{
+	b2ContactEdge* prev = NULL;
+	b2ContactEdge* next = list;
+	while (next && b2ContactManager::LessThan(next->contact, edge->contact))
+	{
+		prev = next;
+		next = next->next;
+	}
+
+	edge->prev = prev;
+	edge->next = next;
+
+	if (prev)
+	{
+		prev->next = edge;
+	}
+	else
+	{
+		list = edge;
+	}
+
+	if (next)
+	{
+		next->prev = edge;
+	}
+}
+
+void b2ContactManager::SortContacts(int32 count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	if (count > m_sortCapacity)
+	{
+		b2Free(m_sortBuffer);
+		m_sortCapacity = b2Max(count, 2 * m_sortCapacity);
+		m_sortBuffer = (b2Contact**)b2Alloc(m_sortCapacity * sizeof(b2Contact*));
+	}
+
+	b2Contact* rest = m_contactList;
+	for (int32 i = 0; i < count; ++i)
+	{
+		m_sortBuffer[i] = rest;
+		rest = rest->m_next;
+	}
+
+	std::sort(m_sortBuffer, m_sortBuffer + count, LessThan);
+
+	// Take the edges out first, so that they are only compared with edges
+	// that are in order.
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Contact* c = m_sortBuffer[i];
+		b2RemoveEdge(c->m_fixtureA->m_body->m_contactList, &c->m_nodeA);
+		b2RemoveEdge(c->m_fixtureB->m_body->m_contactList, &c->m_nodeB);
+	}
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Contact* c = m_sortBuffer[i];
+		b2InsertEdge(c->m_fixtureA->m_body->m_contactList, &c->m_nodeA);
+		b2InsertEdge(c->m_fixtureB->m_body->m_contactList, &c->m_nodeB);
+	}
+
+	// Merge the sorted contacts with the rest of the list.
+	b2Contact* head = NULL;
+	b2Contact* tail = NULL;
+	int32 index = 0;
+	while (index < count || rest)
+	{
+		b2Contact* c;
+		if (rest == NULL || (index < count && LessThan(m_sortBuffer[index], rest)))
+		{
+			c = m_sortBuffer[index++];
+		}
+		else
+		{
+			c = rest;
+			rest = rest->m_next;
+		}
+
+		c->m_prev = tail;
+		if (tail)
+		{
+			tail->m_next = c;
+		}
+		else
+		{
+			head = c;
+		}
+		tail = c;
+	}
+
+	tail->m_next = NULL;
+	m_contactList = head;
 }
 
 void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
@@ -223,6 +387,17 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		edge = edge->next;
 	}
 
+	// Let the creation order rather than the proxy ids decide which fixture comes first.
+	if (m_deterministic)
+	{
+		if (fixtureB->m_order < fixtureA->m_order)
+		{
+			b2Swap(fixtureA, fixtureB);
+			b2Swap(indexA, indexB);
+			b2Swap(bodyA, bodyB);
+		}
+	}
+
 	// Does a joint override collision? Is at least one body dynamic?
 	if (bodyB->ShouldCollide(bodyA) == false)
 	{
@@ -31,6 +31,7 @@ class b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
@@ -40,6 +41,13 @@ public:
 	void Destroy(b2Contact* c);
 
 	void Collide();
+
+	// Move the first count contacts of the list, and their edges, to their
+	// place in the deterministic order. The rest needs to be in order already.
+	void SortContacts(int32 count);
+
+	// The deterministic order: by fixture creation order, then child index.
+	static bool LessThan(const b2Contact* a, const b2Contact* b);
             
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
@@ -47,6 +55,11 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	// Keep contacts in an order that does not depend on the broad-phase.
+	bool m_deterministic;
+	b2Contact** m_sortBuffer;
+	int32 m_sortCapacity;
 };
 
 #endif
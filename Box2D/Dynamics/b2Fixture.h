@@ -233,6 +233,9 @@ protected:
 	bool m_isSensor;
 
 	void* m_userData;
+
+	// The order in which the fixture was created in its world.
+	uint32 m_order;
 };
 
 inline b2Shape::Type b2Fixture::GetType() const
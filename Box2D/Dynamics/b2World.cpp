@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2Island.h>
 #include <Box2D/Dynamics/Joints/b2PulleyJoint.h>
+#include <Box2D/Dynamics/Joints/b2GearJoint.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
 #include <Box2D/Dynamics/Contacts/b2ContactSolver.h>
 #include <Box2D/Collision/b2Collision.h>
@@ -33,6 +34,8 @@
 #include <Box2D/Common/b2Draw.h>
 #include <Box2D/Common/b2Timer.h>
 #include <new>
+#include <algorithm>
+#include <functional>
 
 b2World::b2World(const b2Vec2& gravity)
 {
@@ -58,6 +61,8 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_inv_dt0 = 0.0f;
 
+	m_fixtureOrder = 0;
+
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
@@ -382,6 +387,22 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+void b2World::SetDeterministic(bool flag)
+{
+	b2Assert(IsLocked() == false);
+	if (flag == m_contactManager.m_deterministic || IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_deterministic = flag;
+	if (flag)
+	{
+		// Existing contacts keep their fixture order, but are put in place.
+		m_contactManager.SortContacts(m_contactManager.m_contactCount);
+	}
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -1279,6 +1300,287 @@ void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 	m_contactManager.m_broadPhase.ShiftOrigin(newOrigin);
 }
 
+// Maps an object of the original world to its copy, see b2World::Clone.
+struct b2ClonePair
+{
+	const void* original;
+	void* clone;
+};
+
+inline bool b2ClonePairLessThan(const b2ClonePair& pair1, const b2ClonePair& pair2)
+{
+	return std::less<const void*>()(pair1.original, pair2.original);
+}
+
+static void* b2FindClone(const b2ClonePair* pairs, int32 count, const void* original)
+{
+	b2ClonePair key;
+	key.original = original;
+	key.clone = NULL;
+
+	const b2ClonePair* pair = std::lower_bound(pairs, pairs + count, key, b2ClonePairLessThan);
+	b2Assert(pair != pairs + count && pair->original == original);
+	return pair->clone;
+}
+
+b2World* b2World::Clone() const
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return NULL;
+	}
+
+	b2World* world = new b2World(m_gravity);
+	world->m_flags = m_flags;
+	world->m_allowSleep = m_allowSleep;
+	world->m_inv_dt0 = m_inv_dt0;
+	world->m_warmStarting = m_warmStarting;
+	world->m_continuousPhysics = m_continuousPhysics;
+	world->m_subStepping = m_subStepping;
+	world->m_stepComplete = m_stepComplete;
+	world->m_fixtureOrder = m_fixtureOrder;
+	world->m_contactManager.m_deterministic = m_contactManager.m_deterministic;
+
+	b2BlockAllocator* allocator = &world->m_blockAllocator;
+
+	// The broad-phase is copied as a whole, so that the proxies keep their ids
+	// and fat AABBs, and new pairs are found in the same order.
+	b2BroadPhase* broadPhase = &world->m_contactManager.m_broadPhase;
+	broadPhase->Copy(m_contactManager.m_broadPhase);
+
+	int32 fixtureCount = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		fixtureCount += b->m_fixtureCount;
+	}
+
+	const int32 contactCount = m_contactManager.m_contactCount;
+	b2ClonePair* bodies = (b2ClonePair*)b2Alloc(b2Max(m_bodyCount, 1) * sizeof(b2ClonePair));
+	b2ClonePair* fixtures = (b2ClonePair*)b2Alloc(b2Max(fixtureCount, 1) * sizeof(b2ClonePair));
+	b2ClonePair* joints = (b2ClonePair*)b2Alloc(b2Max(m_jointCount, 1) * sizeof(b2ClonePair));
+	b2ClonePair* contacts = (b2ClonePair*)b2Alloc(b2Max(contactCount, 1) * sizeof(b2ClonePair));
+
+	// Bodies and their fixtures, appended to keep the order of the lists.
+	int32 bodyIndex = 0;
+	int32 fixtureIndex = 0;
+	b2Body* lastBody = NULL;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		void* mem = allocator->Allocate(sizeof(b2Body));
+		b2Body* body = new (mem) b2Body(*b);
+		body->m_world = world;
+		body->m_prev = lastBody;
+		body->m_next = NULL;
+		body->m_fixtureList = NULL;
+		body->m_fixtureCount = 0;
+		body->m_jointList = NULL;
+		body->m_contactList = NULL;
+
+		if (lastBody)
+		{
+			lastBody->m_next = body;
+		}
+		else
+		{
+			world->m_bodyList = body;
+		}
+		lastBody = body;
+		++world->m_bodyCount;
+
+		bodies[bodyIndex].original = b;
+		bodies[bodyIndex].clone = body;
+		++bodyIndex;
+
+		b2Fixture* lastFixture = NULL;
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureDef def;
+			def.shape = f->m_shape;
+			def.userData = f->m_userData;
+			def.friction = f->m_friction;
+			def.restitution = f->m_restitution;
+			def.density = f->m_density;
+			def.isSensor = f->m_isSensor;
+			def.filter = f->m_filter;
+
+			void* fixtureMem = allocator->Allocate(sizeof(b2Fixture));
+			b2Fixture* fixture = new (fixtureMem) b2Fixture;
+			fixture->Create(allocator, body, &def);
+			fixture->m_order = f->m_order;
+
+			fixture->m_proxyCount = f->m_proxyCount;
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2FixtureProxy* proxy = fixture->m_proxies + i;
+				*proxy = f->m_proxies[i];
+				proxy->fixture = fixture;
+				broadPhase->SetUserData(proxy->proxyId, proxy);
+			}
+
+			if (lastFixture)
+			{
+				lastFixture->m_next = fixture;
+			}
+			else
+			{
+				body->m_fixtureList = fixture;
+			}
+			lastFixture = fixture;
+			++body->m_fixtureCount;
+
+			fixtures[fixtureIndex].original = f;
+			fixtures[fixtureIndex].clone = fixture;
+			++fixtureIndex;
+		}
+	}
+
+	std::sort(bodies, bodies + m_bodyCount, b2ClonePairLessThan);
+	std::sort(fixtures, fixtures + fixtureCount, b2ClonePairLessThan);
+
+	// Joints, with their warm starting impulses.
+	int32 jointIndex = 0;
+	b2Joint* lastJoint = NULL;
+	for (const b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2Joint* joint = b2Joint::Clone(j, allocator);
+		joint->m_bodyA = (b2Body*)b2FindClone(bodies, m_bodyCount, j->m_bodyA);
+		joint->m_bodyB = (b2Body*)b2FindClone(bodies, m_bodyCount, j->m_bodyB);
+		joint->m_prev = lastJoint;
+		joint->m_next = NULL;
+
+		joint->m_edgeA.joint = joint;
+		joint->m_edgeA.other = joint->m_bodyB;
+		joint->m_edgeB.joint = joint;
+		joint->m_edgeB.other = joint->m_bodyA;
+
+		if (lastJoint)
+		{
+			lastJoint->m_next = joint;
+		}
+		else
+		{
+			world->m_jointList = joint;
+		}
+		lastJoint = joint;
+		++world->m_jointCount;
+
+		joints[jointIndex].original = j;
+		joints[jointIndex].clone = joint;
+		++jointIndex;
+	}
+
+	std::sort(joints, joints + m_jointCount, b2ClonePairLessThan);
+
+	// Gear joints refer to other joints and their bodies.
+	for (b2Joint* j = world->m_jointList; j; j = j->m_next)
+	{
+		if (j->m_type == e_gearJoint)
+		{
+			b2GearJoint* gear = (b2GearJoint*)j;
+			gear->m_joint1 = (b2Joint*)b2FindClone(joints, m_jointCount, gear->m_joint1);
+			gear->m_joint2 = (b2Joint*)b2FindClone(joints, m_jointCount, gear->m_joint2);
+			gear->m_bodyC = (b2Body*)b2FindClone(bodies, m_bodyCount, gear->m_bodyC);
+			gear->m_bodyD = (b2Body*)b2FindClone(bodies, m_bodyCount, gear->m_bodyD);
+		}
+	}
+
+	// Contacts, with their manifolds and so their warm starting impulses.
+	int32 contactIndex = 0;
+	b2Contact* lastContact = NULL;
+	for (const b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2Fixture* fixtureA = (b2Fixture*)b2FindClone(fixtures, fixtureCount, c->m_fixtureA);
+		b2Fixture* fixtureB = (b2Fixture*)b2FindClone(fixtures, fixtureCount, c->m_fixtureB);
+
+		// The fixtures are already in the order the factory wants them.
+		b2Contact* contact = b2Contact::Create(fixtureA, c->m_indexA, fixtureB, c->m_indexB, allocator);
+		b2Assert(contact->m_fixtureA == fixtureA);
+
+		contact->m_flags = c->m_flags;
+		contact->m_manifold = c->m_manifold;
+		contact->m_toiCount = c->m_toiCount;
+		contact->m_toi = c->m_toi;
+		contact->m_friction = c->m_friction;
+		contact->m_restitution = c->m_restitution;
+		contact->m_tangentSpeed = c->m_tangentSpeed;
+
+		contact->m_nodeA.contact = contact;
+		contact->m_nodeA.other = fixtureB->m_body;
+		contact->m_nodeB.contact = contact;
+		contact->m_nodeB.other = fixtureA->m_body;
+
+		contact->m_prev = lastContact;
+		contact->m_next = NULL;
+		if (lastContact)
+		{
+			lastContact->m_next = contact;
+		}
+		else
+		{
+			world->m_contactManager.m_contactList = contact;
+		}
+		lastContact = contact;
+		++world->m_contactManager.m_contactCount;
+
+		contacts[contactIndex].original = c;
+		contacts[contactIndex].clone = contact;
+		++contactIndex;
+	}
+
+	std::sort(contacts, contacts + contactCount, b2ClonePairLessThan);
+
+	// The joint and contact edges of each body, in the order of the original,
+	// since it determines the order in which islands are solved.
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2Body* body = (b2Body*)b2FindClone(bodies, m_bodyCount, b);
+
+		b2JointEdge* lastJointEdge = NULL;
+		for (const b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			b2Joint* joint = (b2Joint*)b2FindClone(joints, m_jointCount, je->joint);
+			b2JointEdge* edge = joint->m_bodyA == body ? &joint->m_edgeA : &joint->m_edgeB;
+			edge->prev = lastJointEdge;
+			edge->next = NULL;
+			if (lastJointEdge)
+			{
+				lastJointEdge->next = edge;
+			}
+			else
+			{
+				body->m_jointList = edge;
+			}
+			lastJointEdge = edge;
+		}
+
+		b2ContactEdge* lastContactEdge = NULL;
+		for (const b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* contact = (b2Contact*)b2FindClone(contacts, contactCount, ce->contact);
+			b2ContactEdge* edge = contact->m_fixtureA->m_body == body ? &contact->m_nodeA : &contact->m_nodeB;
+			edge->prev = lastContactEdge;
+			edge->next = NULL;
+			if (lastContactEdge)
+			{
+				lastContactEdge->next = edge;
+			}
+			else
+			{
+				body->m_contactList = edge;
+			}
+			lastContactEdge = edge;
+		}
+	}
+
+	b2Free(contacts);
+	b2Free(joints);
+	b2Free(fixtures);
+	b2Free(bodies);
+
+	return world;
+}
+
 void b2World::Dump()
 {
 	if ((m_flags & e_locked) == e_locked)
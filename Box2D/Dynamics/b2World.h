@@ -34,6 +34,7 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2WorldState;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -199,6 +200,33 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Create a deep copy of this world: its bodies, fixtures, joints and contacts,
+	/// including the warm starting impulses, in the same order. User data is
+	/// copied as is. The listeners, the contact filter and the debug draw are not
+	/// copied, so the copy can be stepped on another thread. The caller owns the copy.
+	/// @warning this should be called outside of a time step.
+	b2World* Clone() const;
+
+	/// Save the state of the simulation: the motion of the bodies, the contacts
+	/// with their warm starting impulses and the joints with their impulses.
+	/// Stepping on from a restored state gives the same results as the first time.
+	/// @warning this should be called outside of a time step.
+	void SaveState(b2WorldState* state) const;
+
+	/// Restore a state saved with SaveState. This only works when the same bodies,
+	/// fixtures and joints exist as when the state was saved. Otherwise the world
+	/// is left untouched and false is returned. Contacts created or destroyed
+	/// since are undone without calling the contact listener.
+	/// @warning this should be called outside of a time step.
+	bool RestoreState(const b2WorldState* state);
+
+	/// Enable/disable deterministic ordering. Contacts are then kept in the order
+	/// of their fixtures' creation, instead of the order in which the broad-phase
+	/// found them, so that a world rebuilt with the same bodies and fixtures
+	/// steps to bit-identical results. Costs a sort of the new contacts.
+	void SetDeterministic(bool flag);
+	bool GetDeterministic() const;
+
 	/// Get the contact manager for testing.
 	const b2ContactManager& GetContactManager() const;
 
@@ -260,6 +288,9 @@ private:
 
 	bool m_stepComplete;
 
+	// Number of fixtures created so far, to give each its creation order.
+	uint32 m_fixtureOrder;
+
 	b2Profile m_profile;
 };
 
@@ -341,6 +372,11 @@ inline bool b2World::GetAutoClearForces() const
 	return (m_flags & e_clearForces) == e_clearForces;
 }
 
+inline bool b2World::GetDeterministic() const
+{
+	return m_contactManager.m_deterministic;
+}
+
 inline const b2ContactManager& b2World::GetContactManager() const
 {
 	return m_contactManager;
@@ -0,0 +1,420 @@
+/*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Dynamics/b2WorldState.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/Joints/b2Joint.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <algorithm>
+#include <functional>
+
+// Makes room for count elements. The old contents are not kept.
+template <typename T>
+static void b2Reserve(T*& array, int32& capacity, int32 count)
+{
+	if (count <= capacity)
+	{
+		return;
+	}
+
+	b2Free(array);
+	capacity = b2Max(count, 2 * capacity);
+	array = (T*)b2Alloc(capacity * sizeof(T));
+}
+
+template <typename T>
+inline bool b2PointerLessThan(const T& a, const T& b)
+{
+	return std::less<const void*>()(a.contact, b.contact);
+}
+
+b2WorldState::b2WorldState()
+{
+	m_valid = false;
+
+	m_flags = 0;
+	m_inv_dt0 = 0.0f;
+	m_stepComplete = true;
+
+	m_bodies = NULL;
+	m_bodyCount = 0;
+	m_bodyCapacity = 0;
+
+	m_fixtures = NULL;
+	m_fixtureCount = 0;
+	m_fixtureCapacity = 0;
+
+	m_proxies = NULL;
+	m_proxyCount = 0;
+	m_proxyCapacity = 0;
+
+	m_joints = NULL;
+	m_jointCount = 0;
+	m_jointCapacity = 0;
+
+	m_contacts = NULL;
+	m_contactCount = 0;
+	m_contactCapacity = 0;
+
+	m_contactEdges = NULL;
+	m_contactEdgeCount = 0;
+	m_contactEdgeCapacity = 0;
+
+	m_contactIndices = NULL;
+	m_contactIndexCapacity = 0;
+}
+
+b2WorldState::~b2WorldState()
+{
+	b2Free(m_bodies);
+	b2Free(m_fixtures);
+	b2Free(m_proxies);
+	b2Free(m_joints);
+	b2Free(m_contacts);
+	b2Free(m_contactEdges);
+	b2Free(m_contactIndices);
+}
+
+void b2World::SaveState(b2WorldState* state) const
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	int32 fixtureCount = 0;
+	int32 proxyCount = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			++fixtureCount;
+			proxyCount += f->m_proxyCount;
+		}
+	}
+
+	const int32 contactCount = m_contactManager.m_contactCount;
+
+	b2Reserve(state->m_bodies, state->m_bodyCapacity, m_bodyCount);
+	b2Reserve(state->m_fixtures, state->m_fixtureCapacity, fixtureCount);
+	b2Reserve(state->m_proxies, state->m_proxyCapacity, proxyCount);
+	b2Reserve(state->m_joints, state->m_jointCapacity, m_jointCount);
+	b2Reserve(state->m_contacts, state->m_contactCapacity, contactCount);
+	b2Reserve(state->m_contactEdges, state->m_contactEdgeCapacity, 2 * contactCount);
+	b2Reserve(state->m_contactIndices, state->m_contactIndexCapacity, contactCount);
+
+	state->m_flags = m_flags;
+	state->m_inv_dt0 = m_inv_dt0;
+	state->m_stepComplete = m_stepComplete;
+
+	// Contacts, in the order of the world.
+	int32 contactIndex = 0;
+	for (const b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2WorldState::ContactState* cs = state->m_contacts + contactIndex;
+		cs->fixtureA = c->m_fixtureA;
+		cs->fixtureB = c->m_fixtureB;
+		cs->indexA = c->m_indexA;
+		cs->indexB = c->m_indexB;
+		cs->flags = c->m_flags;
+		cs->manifold = c->m_manifold;
+		cs->toiCount = c->m_toiCount;
+		cs->toi = c->m_toi;
+		cs->friction = c->m_friction;
+		cs->restitution = c->m_restitution;
+		cs->tangentSpeed = c->m_tangentSpeed;
+
+		state->m_contactIndices[contactIndex].contact = c;
+		state->m_contactIndices[contactIndex].index = contactIndex;
+		++contactIndex;
+	}
+	state->m_contactCount = contactCount;
+
+	b2WorldState::ContactIndex* indices = state->m_contactIndices;
+	std::sort(indices, indices + contactCount, b2PointerLessThan<b2WorldState::ContactIndex>);
+
+	// Bodies, with their fixtures and the order of their contact edges.
+	int32 bodyIndex = 0;
+	int32 fixtureIndex = 0;
+	int32 proxyIndex = 0;
+	int32 edgeIndex = 0;
+	for (const b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2WorldState::BodyState* bs = state->m_bodies + bodyIndex++;
+		bs->body = const_cast<b2Body*>(b);
+		bs->xf = b->m_xf;
+		bs->sweep = b->m_sweep;
+		bs->linearVelocity = b->m_linearVelocity;
+		bs->angularVelocity = b->m_angularVelocity;
+		bs->force = b->m_force;
+		bs->torque = b->m_torque;
+		bs->sleepTime = b->m_sleepTime;
+		bs->flags = b->m_flags;
+		bs->type = b->m_type;
+		bs->fixtureCount = b->m_fixtureCount;
+
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2WorldState::FixtureState* fs = state->m_fixtures + fixtureIndex++;
+			fs->fixture = const_cast<b2Fixture*>(f);
+			fs->proxyCount = f->m_proxyCount;
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2WorldState::ProxyState* ps = state->m_proxies + proxyIndex++;
+				ps->proxyId = f->m_proxies[i].proxyId;
+				ps->aabb = f->m_proxies[i].aabb;
+			}
+		}
+
+		bs->contactEdgeCount = 0;
+		for (const b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2WorldState::ContactIndex key;
+			key.contact = ce->contact;
+			key.index = 0;
+			const b2WorldState::ContactIndex* found = std::lower_bound(indices, indices + contactCount, key,
+				b2PointerLessThan<b2WorldState::ContactIndex>);
+			b2Assert(found != indices + contactCount && found->contact == ce->contact);
+
+			state->m_contactEdges[edgeIndex++] = found->index;
+			++bs->contactEdgeCount;
+		}
+	}
+	state->m_bodyCount = m_bodyCount;
+	state->m_fixtureCount = fixtureCount;
+	state->m_proxyCount = proxyCount;
+	state->m_contactEdgeCount = edgeIndex;
+
+	// Joints, with the impulses they warm start from.
+	int32 jointIndex = 0;
+	for (const b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2WorldState::JointState* js = state->m_joints + jointIndex++;
+		js->joint = const_cast<b2Joint*>(j);
+		b2Joint::GetSolverState(j, &js->solverState);
+	}
+	state->m_jointCount = m_jointCount;
+
+	state->m_broadPhase.Copy(m_contactManager.m_broadPhase);
+
+	state->m_valid = true;
+}
+
+bool b2World::RestoreState(const b2WorldState* state)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked() || state->m_valid == false)
+	{
+		return false;
+	}
+
+	// The world needs to be made of the same objects as when it was saved.
+	if (state->m_bodyCount != m_bodyCount || state->m_jointCount != m_jointCount ||
+		state->m_broadPhase.GetProxyCount() != m_contactManager.m_broadPhase.GetProxyCount())
+	{
+		return false;
+	}
+
+	int32 bodyIndex = 0;
+	int32 fixtureIndex = 0;
+	int32 proxyIndex = 0;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		const b2WorldState::BodyState* bs = state->m_bodies + bodyIndex++;
+		if (bs->body != b || bs->type != b->m_type || bs->fixtureCount != b->m_fixtureCount ||
+			(bs->flags & b2Body::e_activeFlag) != (b->m_flags & b2Body::e_activeFlag))
+		{
+			return false;
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			const b2WorldState::FixtureState* fs = state->m_fixtures + fixtureIndex++;
+			if (fs->fixture != f || fs->proxyCount != f->m_proxyCount)
+			{
+				return false;
+			}
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				if (state->m_proxies[proxyIndex++].proxyId != f->m_proxies[i].proxyId)
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	int32 jointIndex = 0;
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		if (state->m_joints[jointIndex++].joint != j)
+		{
+			return false;
+		}
+	}
+
+	// Find the contacts that still exist.
+	const int32 contactCount = state->m_contactCount;
+	b2Contact** contacts = (b2Contact**)b2Alloc(b2Max(contactCount, 1) * sizeof(b2Contact*));
+	b2WorldState::ContactIndex* kept = (b2WorldState::ContactIndex*)b2Alloc(b2Max(contactCount, 1) * sizeof(b2WorldState::ContactIndex));
+	int32 keptCount = 0;
+
+	for (int32 i = 0; i < contactCount; ++i)
+	{
+		const b2WorldState::ContactState* cs = state->m_contacts + i;
+		contacts[i] = NULL;
+
+		for (b2ContactEdge* ce = cs->fixtureA->m_body->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* c = ce->contact;
+			if (c->m_fixtureA == cs->fixtureA && c->m_fixtureB == cs->fixtureB &&
+				c->m_indexA == cs->indexA && c->m_indexB == cs->indexB)
+			{
+				contacts[i] = c;
+				kept[keptCount].contact = c;
+				kept[keptCount].index = i;
+				++keptCount;
+				break;
+			}
+		}
+	}
+
+	std::sort(kept, kept + keptCount, b2PointerLessThan<b2WorldState::ContactIndex>);
+
+	// Remove the contacts that were created since, without reporting them to
+	// the contact listener.
+	b2Contact* c = m_contactManager.m_contactList;
+	while (c)
+	{
+		b2Contact* next = c->m_next;
+
+		b2WorldState::ContactIndex key;
+		key.contact = c;
+		key.index = 0;
+		const b2WorldState::ContactIndex* found = std::lower_bound(kept, kept + keptCount, key,
+			b2PointerLessThan<b2WorldState::ContactIndex>);
+		if (found == kept + keptCount || found->contact != c)
+		{
+			c->m_flags &= ~b2Contact::e_touchingFlag;
+			m_contactManager.Destroy(c);
+		}
+
+		c = next;
+	}
+
+	// Bring back the ones that were destroyed since.
+	for (int32 i = 0; i < contactCount; ++i)
+	{
+		if (contacts[i] == NULL)
+		{
+			const b2WorldState::ContactState* cs = state->m_contacts + i;
+			contacts[i] = b2Contact::Create(cs->fixtureA, cs->indexA, cs->fixtureB, cs->indexB, &m_blockAllocator);
+			b2Assert(contacts[i] != NULL && contacts[i]->m_fixtureA == cs->fixtureA);
+		}
+	}
+
+	// Restore the contacts and put them back in their order.
+	for (int32 i = 0; i < contactCount; ++i)
+	{
+		const b2WorldState::ContactState* cs = state->m_contacts + i;
+		b2Contact* contact = contacts[i];
+
+		contact->m_flags = cs->flags;
+		contact->m_manifold = cs->manifold;
+		contact->m_toiCount = cs->toiCount;
+		contact->m_toi = cs->toi;
+		contact->m_friction = cs->friction;
+		contact->m_restitution = cs->restitution;
+		contact->m_tangentSpeed = cs->tangentSpeed;
+
+		contact->m_prev = i > 0 ? contacts[i - 1] : NULL;
+		contact->m_next = i + 1 < contactCount ? contacts[i + 1] : NULL;
+
+		contact->m_nodeA.contact = contact;
+		contact->m_nodeA.other = contact->m_fixtureB->m_body;
+		contact->m_nodeB.contact = contact;
+		contact->m_nodeB.other = contact->m_fixtureA->m_body;
+	}
+	m_contactManager.m_contactList = contactCount > 0 ? contacts[0] : NULL;
+	m_contactManager.m_contactCount = contactCount;
+
+	// Restore the bodies and their contact edges.
+	bodyIndex = 0;
+	proxyIndex = 0;
+	int32 edgeIndex = 0;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		const b2WorldState::BodyState* bs = state->m_bodies + bodyIndex++;
+		b->m_xf = bs->xf;
+		b->m_sweep = bs->sweep;
+		b->m_linearVelocity = bs->linearVelocity;
+		b->m_angularVelocity = bs->angularVelocity;
+		b->m_force = bs->force;
+		b->m_torque = bs->torque;
+		b->m_sleepTime = bs->sleepTime;
+		b->m_flags = bs->flags;
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				f->m_proxies[i].aabb = state->m_proxies[proxyIndex++].aabb;
+			}
+		}
+
+		b2ContactEdge* lastEdge = NULL;
+		b->m_contactList = NULL;
+		for (int32 i = 0; i < bs->contactEdgeCount; ++i)
+		{
+			b2Contact* contact = contacts[state->m_contactEdges[edgeIndex++]];
+			b2ContactEdge* edge = contact->m_fixtureA->m_body == b ? &contact->m_nodeA : &contact->m_nodeB;
+			edge->prev = lastEdge;
+			edge->next = NULL;
+			if (lastEdge)
+			{
+				lastEdge->next = edge;
+			}
+			else
+			{
+				b->m_contactList = edge;
+			}
+			lastEdge = edge;
+		}
+	}
+
+	// Restore the impulses of the joints. Their parameters are left as they
+	// are, they belong to the application rather than to the simulation.
+	for (int32 i = 0; i < state->m_jointCount; ++i)
+	{
+		b2Joint::SetSolverState(state->m_joints[i].joint, state->m_joints[i].solverState);
+	}
+
+	m_contactManager.m_broadPhase.Copy(state->m_broadPhase);
+
+	m_flags = state->m_flags & ~e_locked;
+	m_inv_dt0 = state->m_inv_dt0;
+	m_stepComplete = state->m_stepComplete;
+
+	b2Free(kept);
+	b2Free(contacts);
+
+	return true;
+}
@@ -0,0 +1,146 @@
+/*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_WORLD_STATE_H
+#define B2_WORLD_STATE_H
+
+#include <Box2D/Common/b2Math.h>
+#include <Box2D/Collision/b2Collision.h>
+#include <Box2D/Collision/b2BroadPhase.h>
+#include <Box2D/Dynamics/Joints/b2Joint.h>
+
+class b2Body;
+class b2Fixture;
+class b2Contact;
+
+/// The state of a world between two time steps: the motion of the bodies, the
+/// contacts with their warm starting impulses, the joints with their impulses
+/// and the broad-phase. It is saved with b2World::SaveState and restored with
+/// b2World::RestoreState, which is much faster than rebuilding the world.
+/// The buffers are kept between saves, so a state can be reused every step.
+class b2WorldState
+{
+public:
+	b2WorldState();
+	~b2WorldState();
+
+	/// Does this hold a saved state?
+	bool IsValid() const { return m_valid; }
+
+	/// Forget the saved state, keeping the buffers.
+	void Clear() { m_valid = false; }
+
+private:
+
+	friend class b2World;
+
+	struct BodyState
+	{
+		b2Body* body;
+		b2Transform xf;
+		b2Sweep sweep;
+		b2Vec2 linearVelocity;
+		float32 angularVelocity;
+		b2Vec2 force;
+		float32 torque;
+		float32 sleepTime;
+		uint16 flags;
+		int32 type;
+		int32 fixtureCount;
+		int32 contactEdgeCount;
+	};
+
+	struct FixtureState
+	{
+		b2Fixture* fixture;
+		int32 proxyCount;
+	};
+
+	struct ProxyState
+	{
+		int32 proxyId;
+		b2AABB aabb;
+	};
+
+	struct JointState
+	{
+		b2Joint* joint;
+		b2JointSolverState solverState;
+	};
+
+	struct ContactState
+	{
+		b2Fixture* fixtureA;
+		b2Fixture* fixtureB;
+		int32 indexA;
+		int32 indexB;
+		uint32 flags;
+		b2Manifold manifold;
+		int32 toiCount;
+		float32 toi;
+		float32 friction;
+		float32 restitution;
+		float32 tangentSpeed;
+	};
+
+	struct ContactIndex
+	{
+		const b2Contact* contact;
+		int32 index;
+	};
+
+	b2WorldState(const b2WorldState&);
+	b2WorldState& operator=(const b2WorldState&);
+
+	bool m_valid;
+
+	int32 m_flags;
+	float32 m_inv_dt0;
+	bool m_stepComplete;
+
+	BodyState* m_bodies;
+	int32 m_bodyCount;
+	int32 m_bodyCapacity;
+
+	FixtureState* m_fixtures;
+	int32 m_fixtureCount;
+	int32 m_fixtureCapacity;
+
+	ProxyState* m_proxies;
+	int32 m_proxyCount;
+	int32 m_proxyCapacity;
+
+	JointState* m_joints;
+	int32 m_jointCount;
+	int32 m_jointCapacity;
+
+	ContactState* m_contacts;
+	int32 m_contactCount;
+	int32 m_contactCapacity;
+
+	// For each body, the indices of its contacts in the order of its edges.
+	int32* m_contactEdges;
+	int32 m_contactEdgeCount;
+	int32 m_contactEdgeCapacity;
+
+	// Scratch space for looking up the index of a contact while saving.
+	ContactIndex* m_contactIndices;
+	int32 m_contactIndexCapacity;
+
+	b2BroadPhase m_broadPhase;
+};
+
+#endif
@@ -40,6 +40,7 @@ SOURCES += \
     $$PWD/Dynamics/Joints/b2DistanceJoint.cpp \
     $$PWD/Dynamics/b2WorldCallbacks.cpp \
     $$PWD/Dynamics/b2World.cpp \
+    $$PWD/Dynamics/b2WorldState.cpp \
     $$PWD/Dynamics/b2Island.cpp \
     $$PWD/Dynamics/b2Fixture.cpp \
     $$PWD/Dynamics/b2ContactManager.cpp \
@@ -88,6 +89,7 @@ HEADERS += \
     $$PWD/Dynamics/Joints/b2DistanceJoint.h \
     $$PWD/Dynamics/b2WorldCallbacks.h \
     $$PWD/Dynamics/b2World.h \
+    $$PWD/Dynamics/b2WorldState.h \
     $$PWD/Dynamics/b2TimeStep.h \
     $$PWD/Dynamics/b2Island.h \
     $$PWD/Dynamics/b2Fixture.h \
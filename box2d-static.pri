@@ -20,8 +20,15 @@ include(Box2D/box2d.pri)
 
 SOURCES += $$PWD/box2dplugin.cpp \
     $$PWD/box2dworld.cpp \
+    $$PWD/box2dcoreworld.cpp \
+    $$PWD/box2dworldbatch.cpp \
+    $$PWD/box2dshardedworld.cpp \
     $$PWD/box2dbody.cpp \
+    $$PWD/box2dbodypool.cpp \
+    $$PWD/box2dbodyinstancer.cpp \
+    $$PWD/box2dlightbody.cpp \
     $$PWD/box2dfixture.cpp \
+    $$PWD/box2dlightfixture.cpp \
     $$PWD/box2ddebugdraw.cpp \
     $$PWD/box2djoint.cpp \
     $$PWD/box2drevolutejoint.cpp \
@@ -35,15 +42,23 @@ SOURCES += $$PWD/box2dplugin.cpp \
     $$PWD/box2dwheeljoint.cpp \
     $$PWD/box2dmousejoint.cpp \
     $$PWD/box2dgearjoint.cpp \
-    $$PWD/box2dropejoint.cpp
+    $$PWD/box2dropejoint.cpp \
+    $$PWD/box2dscheduler.cpp
 
 
 
 HEADERS += \
     $$PWD/box2dplugin.h \
     $$PWD/box2dworld.h \
+    $$PWD/box2dcoreworld.h \
+    $$PWD/box2dworldbatch.h \
+    $$PWD/box2dshardedworld.h \
     $$PWD/box2dbody.h \
+    $$PWD/box2dbodypool.h \
+    $$PWD/box2dbodyinstancer.h \
+    $$PWD/box2dlightbody.h \
     $$PWD/box2dfixture.h \
+    $$PWD/box2dlightfixture.h \
     $$PWD/box2ddebugdraw.h \
     $$PWD/box2djoint.h \
     $$PWD/box2drevolutejoint.h \
@@ -57,5 +72,6 @@ HEADERS += \
     $$PWD/box2dwheeljoint.h \
     $$PWD/box2dmousejoint.h \
     $$PWD/box2dgearjoint.h \
-    $$PWD/box2dropejoint.h
+    $$PWD/box2dropejoint.h \
+    $$PWD/box2dscheduler.h
 
@@ -15,8 +15,15 @@ include(../Box2D/box2d.pri)
 
 SOURCES += \
     box2dworld.cpp \
+    box2dcoreworld.cpp \
+    box2dworldbatch.cpp \
+    box2dshardedworld.cpp \
     box2dbody.cpp \
+    box2dbodypool.cpp \
+    box2dbodyinstancer.cpp \
+    box2dlightbody.cpp \
     box2dfixture.cpp \
+    box2dlightfixture.cpp \
     box2ddebugdraw.cpp \
     box2djoint.cpp \
     box2ddistancejoint.cpp \
@@ -31,12 +38,20 @@ SOURCES += \
     box2dmousejoint.cpp \
     box2dgearjoint.cpp \
     box2dropejoint.cpp \
+    box2dscheduler.cpp \
     box2dplugin.cpp
 HEADERS += \
     box2dplugin.h \
     box2dworld.h \
+    box2dcoreworld.h \
+    box2dworldbatch.h \
+    box2dshardedworld.h \
     box2dbody.h \
+    box2dbodypool.h \
+    box2dbodyinstancer.h \
+    box2dlightbody.h \
     box2dfixture.h \
+    box2dlightfixture.h \
     box2ddebugdraw.h \
     box2djoint.h \
     box2ddistancejoint.h \
@@ -50,7 +65,8 @@ HEADERS += \
     box2dwheeljoint.h \
     box2dmousejoint.h \
     box2dgearjoint.h \
-    box2dropejoint.h
+    box2dropejoint.h \
+    box2dscheduler.h
 
 OTHER_FILES = qmldir
 
@@ -32,7 +32,11 @@
 #include "box2dbody.h"
 
 #include "box2dfixture.h"
-#include "box2dworld.h"
+#include "box2dlightfixture.h"
+#include "box2dcoreworld.h"
+
+#include <QQuickTransform>
+#include <QMatrix4x4>
 
 
 /*!
@@ -47,14 +51,67 @@ static, kinematic, or dynamic.
 
 
 
+/*!
+\class Box2DBodyTransform
+Moves a body on screen to where the simulation has it, ahead of its x, y
+and rotation properties. See World::renderOnlyTransforms.
+*/
+class Box2DBodyTransform : public QQuickTransform
+{
+public:
+    explicit Box2DBodyTransform(QObject *parent)
+        : QQuickTransform(parent), mX(0), mY(0), mRotation(0) {}
+
+    qreal x() const { return mX; }
+    qreal y() const { return mY; }
+    qreal rotation() const { return mRotation; }
+
+    bool isNull() const { return mX == 0 && mY == 0 && mRotation == 0; }
+
+    void setOffset(qreal x, qreal y, qreal rotation)
+    {
+        if (mX == x && mY == y && mRotation == rotation)
+            return;
+
+        mX = x;
+        mY = y;
+        mRotation = rotation;
+        update();
+    }
+
+    // Applied after the position of the item and before its rotation,
+    // which is around its top left corner.
+    void applyTo(QMatrix4x4 *matrix) const
+    {
+        matrix->translate(mX, mY);
+        if (mRotation != 0)
+            matrix->rotate(mRotation, 0, 0, 1);
+    }
+
+private:
+    qreal mX;
+    qreal mY;
+    qreal mRotation;
+};
+
 Box2DBody::Box2DBody(QQuickItem *parent) :
     QQuickItem(parent),
     mBody(0),
     mWorld(0),
+    mCoreWorld(0),
     mBodyDef(),
+    mAngle(0),
     mSynchronizing(false),
     mInitializePending(false),
-    mGravityScale(1.0)
+    mOutsideFocus(false),
+    mDeactivatedByFocus(false),
+    mRenderTransform(0),
+    mIndex(-1),
+    mGravityScale(1.0),
+    mObservedProperties(0),
+    mObservedAngularVelocity(0),
+    mObservedAwake(false),
+    mAwakePending(false)
 {
     setTransformOrigin(TopLeft);
     connect(this, SIGNAL(rotationChanged()), SLOT(onRotationChanged()));
@@ -71,7 +128,6 @@ Box2DBody::~Box2DBody()
 
 qreal Box2DBody::linearDamping() const
 {
-    if(mBody) return mBody->GetLinearDamping();
     return mBodyDef.linearDamping;
 }
 
@@ -79,10 +135,9 @@ void Box2DBody::setLinearDamping(qreal _linearDamping)
 {
     if (linearDamping() == _linearDamping)
         return;
+    mBodyDef.linearDamping = _linearDamping;
     if (mBody)
-        mBody->SetLinearDamping(_linearDamping);
-    else
-        mBodyDef.linearDamping = _linearDamping;
+        mCoreWorld->updateBody(this);
 
     emit linearDampingChanged();
 }
@@ -113,17 +168,15 @@ time step. This is not an issue if you use a fixed time step (recommended).
 
 qreal Box2DBody::angularDamping() const
 {
-    if(mBody) return mBody->GetAngularDamping();
     return mBodyDef.angularDamping;
 }
 void Box2DBody::setAngularDamping(qreal _angularDamping)
 {
     if (angularDamping() == _angularDamping)
         return;
+    mBodyDef.angularDamping = _angularDamping;
     if (mBody)
-        mBody->SetAngularDamping(_angularDamping);
-    else
-        mBodyDef.angularDamping = _angularDamping;
+        mCoreWorld->updateBody(this);
 
     emit angularDampingChanged();
 }
@@ -167,7 +220,6 @@ never move relative to each other and fixtures attached to the same body don’t
 
 Box2DBody::BodyType Box2DBody::bodyType() const
 {
-    if(mBody) mBody->GetType();
     return static_cast<Box2DBody::BodyType>(mBodyDef.type);
 }
 
@@ -175,10 +227,11 @@ void Box2DBody::setBodyType(BodyType _bodyType)
 {
     if (bodyType() == _bodyType)
         return;
-    if (mBody)
-        mBody->SetType(static_cast<b2BodyType>(_bodyType));
-    else
-        mBodyDef.type = static_cast<b2BodyType>(_bodyType);
+    mBodyDef.type = static_cast<b2BodyType>(_bodyType);
+    if (mBody) {
+        mCoreWorld->updateBody(this);
+        wakeUpWorld();
+    }
 
     emit bodyTypeChanged();
 }
@@ -212,7 +265,6 @@ The bullet flag only affects dynamic bodies.
 
 bool Box2DBody::isBullet() const
 {
-    if(mBody) mBody->IsBullet();
     return mBodyDef.bullet;
 }
 
@@ -220,10 +272,9 @@ void Box2DBody::setBullet(bool _bullet)
 {
     if (isBullet() == _bullet)
         return;
+    mBodyDef.bullet = _bullet;
     if (mBody)
-        mBody->SetBullet(_bullet);
-    else
-        mBodyDef.bullet = _bullet;
+        mCoreWorld->updateBody(this);
 
     emit bulletChanged();
 }
@@ -257,7 +308,6 @@ Body{
 
 bool Box2DBody::sleepingAllowed() const
 {
-    if(mBody) mBody->IsSleepingAllowed();
     return mBodyDef.allowSleep;
 }
 
@@ -265,10 +315,9 @@ void Box2DBody::setSleepingAllowed(bool allowed)
 {
     if (sleepingAllowed() == allowed)
         return;
+    mBodyDef.allowSleep = allowed;
     if (mBody)
-        mBody->SetSleepingAllowed(allowed);
-    else
-        mBodyDef.allowSleep = allowed;
+        mCoreWorld->updateBody(this);
 
     emit sleepingAllowedChanged();
 }
@@ -290,7 +339,6 @@ You can use the fixedRotation setting to achieve this:
  */
 bool Box2DBody::fixedRotation() const
 {
-    if(mBody) mBody->IsFixedRotation();
     return mBodyDef.fixedRotation;
 }
 
@@ -298,10 +346,9 @@ void Box2DBody::setFixedRotation(bool _fixedRotation)
 {
     if (fixedRotation() == _fixedRotation)
         return;
+    mBodyDef.fixedRotation = _fixedRotation;
     if (mBody)
-        mBody->SetFixedRotation(_fixedRotation);
-    else
-        mBodyDef.fixedRotation = _fixedRotation;
+        mCoreWorld->updateBody(this);
 
     emit fixedRotationChanged();
 }
@@ -338,19 +385,20 @@ Note that activating a body is almost as expensive as creating the body from scr
 
 bool Box2DBody::active() const
 {
-    if(mBody) mBody->IsActive();
+    if (const b2Body *body = readableBody())
+        return body->IsActive();
     return mBodyDef.active;
 }
 
 void Box2DBody::setActive(bool _active)
 {
-    if (active() == _active)
-        return;
-
-    if (mBody)
-        mBody->SetActive(_active);
-    else
-        mBodyDef.active = _active;
+    // The b2Body may not reflect a change that is still queued, so it is
+    // always passed on to the world, which skips it when it changes nothing
+    if (mBody) {
+        mCoreWorld->setBodyActive(this, _active);
+        wakeUpWorld();
+    }
+    mBodyDef.active = _active;
 }
 
 /*!
@@ -359,28 +407,39 @@ void Box2DBody::setActive(bool _active)
  */
 bool Box2DBody::awake() const
 {
-    if(mBody) mBody->IsAwake();
+    // A change queued behind a running step is returned right away
+    const b2Body *body = readableBody();
+    if (body && !mAwakePending)
+        return body->IsAwake();
     return mBodyDef.awake;
 }
 
 void Box2DBody::setAwake(bool _awake)
 {
-    if (awake() == _awake)
-        return;
+    const bool changed = awake() != _awake;
 
-    if (mBody)
-        mBody->SetAwake(_awake);
-    else
-        mBodyDef.awake = _awake;
+    // The b2Body may not reflect a change that is still queued, so it is
+    // always passed on to the world, which skips it when it changes nothing
+    mBodyDef.awake = _awake;
+    if (mBody) {
+        mAwakePending = true;
+        mCoreWorld->setBodyAwake(this, _awake);
+        wakeUpWorld();
+    }
+
+    // Already notified, the observer only reports what the steps change
+    mObservedAwake = _awake;
+    if (changed)
+        emit awakeChanged();
 }
 
 
 
 QPointF Box2DBody::linearVelocity() const
 {
-    b2Vec2 point;
-    if(mBody) point = mBody->GetLinearVelocity();
-    else point = mBodyDef.linearVelocity;
+    const b2Body *body = readableBody();
+    const b2Vec2 point = body ? body->GetLinearVelocity()
+                              : mBodyDef.linearVelocity;
     return QPointF(point.x * scaleRatio,-point.y * scaleRatio);
 }
 
@@ -390,17 +449,130 @@ void Box2DBody::setLinearVelocity(const QPointF &_linearVelocity)
         return;
     b2Vec2 point(_linearVelocity.x() / scaleRatio,
                                             -_linearVelocity.y() / scaleRatio);
-    if (mBody)
-        mBody->SetLinearVelocity(point);
-    else
+    if (mBody) {
+        mCoreWorld->setBodyLinearVelocity(this, point);
+        wakeUpWorld();
+    } else
         mBodyDef.linearVelocity = point;
 
     emit linearVelocityChanged();
 }
 
+/*!
+  \qmlproperty real Body::angularVelocity
+  The angular velocity of the body in degrees per second, clockwise.
+  Only notifies changes made by the simulation when it is observed, see
+  observedProperties.
+*/
+qreal Box2DBody::angularVelocity() const
+{
+    const b2Body *body = readableBody();
+    const float32 angularVelocity = body ? body->GetAngularVelocity()
+                                         : mBodyDef.angularVelocity;
+    return -(angularVelocity * 180.0) / b2_pi;
+}
+
+void Box2DBody::setAngularVelocity(qreal angularVelocity)
+{
+    if (this->angularVelocity() == angularVelocity)
+        return;
+
+    const float32 value = -(angularVelocity * b2_pi) / 180.0;
+    if (mBody) {
+        mCoreWorld->setBodyAngularVelocity(this, value);
+        wakeUpWorld();
+    } else
+        mBodyDef.angularVelocity = value;
+
+    emit angularVelocityChanged();
+}
+
+/*!
+  \qmlproperty flags Body::observedProperties
+  The dynamic properties of the body whose change signals are emitted when
+  the simulation changes them. The world compares them once after each
+  step, for the bodies that observe any, so that they can be bound to
+  without polling. The other bodies are not checked at all.
+
+  \list
+  \li Body.LinearVelocity - linearVelocityChanged
+  \li Body.AngularVelocity - angularVelocityChanged
+  \li Body.Awake - awakeChanged
+  \endlist
+
+  None by default.
+
+\code
+Body {
+    observedProperties: Body.LinearVelocity | Body.Awake
+}
+
+Text {
+    text: body.awake ? Math.round(body.linearVelocity.x) : "asleep"
+}
+\endcode
+*/
+void Box2DBody::setObservedProperties(ObservedProperties observedProperties)
+{
+    if (mObservedProperties == observedProperties)
+        return;
+
+    mObservedProperties = observedProperties;
+    storeObservedValues();
+    if (mCoreWorld)
+        mCoreWorld->observeBody(this);
+
+    emit observedPropertiesChanged();
+}
+
+/**
+ * Remembers the values of the observed properties, to compare them with
+ * after the next step.
+ */
+void Box2DBody::storeObservedValues()
+{
+    const b2Body *body = readableBody();
+    mObservedLinearVelocity = body ? body->GetLinearVelocity() : mBodyDef.linearVelocity;
+    mObservedAngularVelocity = body ? body->GetAngularVelocity() : mBodyDef.angularVelocity;
+    mObservedAwake = awake();
+}
+
+/**
+ * Emits the change signals of the observed properties that were changed
+ * by the simulation. Called by the world after each step.
+ */
+void Box2DBody::emitObservedChanges()
+{
+    if (!mBody)
+        return;
+
+    if (mObservedProperties & LinearVelocity) {
+        const b2Vec2 &linearVelocity = mBody->GetLinearVelocity();
+        if (!(linearVelocity == mObservedLinearVelocity)) {
+            mObservedLinearVelocity = linearVelocity;
+            emit linearVelocityChanged();
+        }
+    }
+
+    if (mObservedProperties & AngularVelocity) {
+        const float32 angularVelocity = mBody->GetAngularVelocity();
+        if (angularVelocity != mObservedAngularVelocity) {
+            mObservedAngularVelocity = angularVelocity;
+            emit angularVelocityChanged();
+        }
+    }
+
+    if (mObservedProperties & Awake) {
+        const bool awake = this->awake();
+        if (awake != mObservedAwake) {
+            mObservedAwake = awake;
+            emit awakeChanged();
+        }
+    }
+}
+
 qreal Box2DBody::gravityScale() const
 {
-    if(mBody) return mBody->GetGravityScale();
     return mGravityScale;
 }
 
@@ -410,10 +582,8 @@ void Box2DBody::setGravityScale(qreal _gravityScale)
         return;
     mGravityScale = _gravityScale;
     if(mBody)
-    {
-        mBody->SetGravityScale(_gravityScale);
-        emit gravityScaleChanged();
-    }
+        mCoreWorld->updateBody(this);
+    emit gravityScaleChanged();
 }
 
 /*!
@@ -464,9 +634,47 @@ Box2DFixture * Box2DBody::at_fixture(QQmlListProperty<Box2DFixture> *list, int i
     return body->mFixtures.at(index);
 }
 
-void Box2DBody::initialize(b2World *world)
+/*!
+ \qmlproperty list<LightFixture> Body::lightFixtures
+ Fixtures of the body that are not items, see \l LightFixture. They are
+ created along with the fixtures.
+ */
+QQmlListProperty<Box2DLightFixture> Box2DBody::lightFixtures()
+{
+    return QQmlListProperty<Box2DLightFixture>(this, 0,
+                                               &Box2DBody::append_light_fixture,
+                                               &Box2DBody::count_light_fixture,
+                                               &Box2DBody::at_light_fixture,
+                                               0);
+}
+
+void Box2DBody::append_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                     Box2DLightFixture *fixture)
 {
-    mWorld = world;
+    Box2DBody *body = static_cast<Box2DBody*>(list->object);
+    fixture->setParent(body);
+    body->mLightFixtures.append(fixture);
+}
+
+int Box2DBody::count_light_fixture(QQmlListProperty<Box2DLightFixture> *list)
+{
+    Box2DBody *body = static_cast<Box2DBody*>(list->object);
+    return body->mLightFixtures.length();
+}
+
+Box2DLightFixture *Box2DBody::at_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                               int index)
+{
+    Box2DBody *body = static_cast<Box2DBody*>(list->object);
+    if (index < 0 || index >= body->mLightFixtures.length())
+        return NULL;
+    return body->mLightFixtures.at(index);
+}
+
+void Box2DBody::initialize(Box2DCoreWorld *world)
+{
+    mCoreWorld = world;
+    mWorld = world->world();
     if (!isComponentComplete()) {
         // When components are created dynamically, they get their parent
         // assigned before they have been completely initialized. In that case
@@ -474,15 +682,61 @@ void Box2DBody::initialize(b2World *world)
         mInitializePending = true;
         return;
     }
+    mInitializePending = false;
+    world->createBody(this);
+}
+
+/**
+ * Creates the b2Body and its fixtures. Called by the world once no step is
+ * running, see World::createBody().
+ */
+void Box2DBody::createBody()
+{
     mBodyDef.position.Set(x() / scaleRatio, -y() / scaleRatio);
     mBodyDef.angle = -(rotation() * (2 * b2_pi)) / 360.0;
-    mBody = world->CreateBody(&mBodyDef);
-    mInitializePending = false;
+    mBody = mWorld->CreateBody(&mBodyDef);
     if(mGravityScale != 1.0)
         mBody->SetGravityScale(mGravityScale);
     foreach (Box2DFixture *fixture, mFixtures)
         fixture->createFixture(mBody);
+    foreach (Box2DLightFixture *fixture, mLightFixtures)
+        fixture->createFixture(mBody);
     mBody->SetUserData(this);
+    resetTransforms();
+    emit bodyCreated();
+}
+
+/**
+ * Takes a b2Body that was created along with its fixtures on the worker
+ * thread of an asynchronous world, see World::asynchronous.
+ */
+void Box2DBody::adoptBody(Box2DCoreWorld *world, b2Body *body)
+{
+    mCoreWorld = world;
+    mWorld = world->world();
+    mInitializePending = false;
+    mBody = body;
+
+    // Follow moves made while the world was being built
+    mBodyDef.position.Set(x() / scaleRatio, -y() / scaleRatio);
+    mBodyDef.angle = -(rotation() * (2 * b2_pi)) / 360.0;
+    if (!(mBodyDef.position == mBody->GetPosition())
+            || mBodyDef.angle != mBody->GetAngle())
+        mBody->SetTransform(mBodyDef.position, mBodyDef.angle);
+
+    // And the state set in the meantime, the rest of the definition is
+    // applied by the world
+    if (!(mBodyDef.linearVelocity == mBody->GetLinearVelocity()))
+        mBody->SetLinearVelocity(mBodyDef.linearVelocity);
+    if (mBodyDef.angularVelocity != mBody->GetAngularVelocity())
+        mBody->SetAngularVelocity(mBodyDef.angularVelocity);
+    if (mBodyDef.active != mBody->IsActive())
+        mBody->SetActive(mBodyDef.active);
+    if (mBodyDef.awake != mBody->IsAwake())
+        mBody->SetAwake(mBodyDef.awake);
+
+    mBody->SetUserData(this);
+    resetTransforms();
     emit bodyCreated();
 }
 
@@ -494,15 +748,28 @@ void Box2DBody::initialize(b2World *world)
 void Box2DBody::synchronize()
 {
     Q_ASSERT(mBody);
-    mSynchronizing = true;
-
-    const b2Vec2 position = mBody->GetPosition();
-    const float32 angle = mBody->GetAngle();
+    synchronize(mBody->GetPosition(), mBody->GetAngle());
+}
 
+/**
+ * Synchronizes the body with a position and angle computed by a step that
+ * ran on the physics thread, see World::threaded.
+ */
+void Box2DBody::synchronize(const b2Vec2 &position, float32 angle)
+{
     const qreal newX = position.x * scaleRatio;
     const qreal newY = -position.y * scaleRatio;
     const qreal newRotation = -(angle * 180.0) / b2_pi;
 
+    // Only move the rendered item, the properties follow on commit
+    if (mRenderTransform) {
+        mRenderTransform->setOffset(newX - x(), newY - y(),
+                                    newRotation - rotation());
+        return;
+    }
+
+    mSynchronizing = true;
+
     if (!qFuzzyCompare(x(), newX))
         setX(newX);
     if (!qFuzzyCompare(y(), newY))
@@ -514,6 +781,132 @@ void Box2DBody::synchronize()
     mSynchronizing = false;
 }
 
+/**
+ * Stores the transforms of the body before and after the last step, to be
+ * blended by interpolate(). See World::interpolating.
+ */
+void Box2DBody::setTransforms(const b2Transform &previous,
+                              const b2Transform &current,
+                              float32 angle)
+{
+    mPreviousTransform = previous;
+    mTransform = current;
+    mAngle = angle;
+}
+
+/**
+ * Synchronizes the body with a transform blended between the last two steps,
+ * where an alpha of 0 is the previous step and 1 the current one.
+ */
+void Box2DBody::interpolate(float32 alpha)
+{
+    if (!mBody)
+        return;
+
+    const b2Vec2 position = (1.0f - alpha) * mPreviousTransform.p
+            + alpha * mTransform.p;
+
+    // Turn back from the current angle along the shortest arc, to stay
+    // continuous with the unbounded angle of the body
+    const float32 delta = b2MulT(mPreviousTransform.q, mTransform.q).GetAngle();
+
+    synchronize(position, mAngle - (1.0f - alpha) * delta);
+}
+
+/**
+ * Whether the body is moved on screen by a transform, leaving its x, y and
+ * rotation properties alone until commitTransform() is called. Set by the
+ * world, see World::renderOnlyTransforms.
+ */
+void Box2DBody::setRenderOnly(bool renderOnly)
+{
+    if (renderOnly == (mRenderTransform != 0))
+        return;
+
+    if (renderOnly) {
+        mRenderTransform = new Box2DBodyTransform(this);
+        mRenderTransform->appendToItem(this);
+    } else {
+        commitTransform();
+        delete mRenderTransform;
+        mRenderTransform = 0;
+    }
+}
+
+/*!
+  \qmlmethod void Body::commitTransform()
+  Updates the x, y and rotation properties to where the body is shown, when
+  the world only moves the rendered items. See World::renderOnlyTransforms.
+*/
+void Box2DBody::commitTransform()
+{
+    if (!mRenderTransform || mRenderTransform->isNull())
+        return;
+
+    const qreal newX = renderedX();
+    const qreal newY = renderedY();
+    const qreal newRotation = renderedRotation();
+    mRenderTransform->setOffset(0, 0, 0);
+
+    mSynchronizing = true;
+
+    if (!qFuzzyCompare(x(), newX))
+        setX(newX);
+    if (!qFuzzyCompare(y(), newY))
+        setY(newY);
+
+    if (!qFuzzyCompare(rotation(), newRotation))
+        setRotation(newRotation);
+
+    mSynchronizing = false;
+}
+
+qreal Box2DBody::renderedX() const
+{
+    return mRenderTransform ? x() + mRenderTransform->x() : x();
+}
+
+qreal Box2DBody::renderedY() const
+{
+    return mRenderTransform ? y() + mRenderTransform->y() : y();
+}
+
+qreal Box2DBody::renderedRotation() const
+{
+    return mRenderTransform ? rotation() + mRenderTransform->rotation() : rotation();
+}
+
+/**
+ * Resumes stepping of an idle world after the body may have been woken up.
+ */
+void Box2DBody::wakeUpWorld()
+{
+    if (mCoreWorld)
+        mCoreWorld->wakeUp();
+}
+
+/**
+ * Returns the b2Body for reading its state on the GUI thread, after waiting
+ * for a step that is running on the physics thread, see World::threaded.
+ */
+const b2Body *Box2DBody::readableBody() const
+{
+    if (mBody && mCoreWorld->isStepPending())
+        mCoreWorld->waitForStep();
+    return mBody;
+}
+
+/**
+ * Makes both stored transforms match the body, so that interpolation does
+ * not undo a transform set from outside of the simulation.
+ */
+void Box2DBody::resetTransforms()
+{
+    mTransform = mBody->GetTransform();
+    mPreviousTransform = mTransform;
+    mAngle = mBody->GetAngle();
+}
+
 /*!
   \qmlsignal Body::cleanup(b2World *world)
    clean up the whole internal  Box2D
@@ -537,9 +930,40 @@ void Box2DBody::synchronize()
 
 void Box2DBody::cleanup(b2World *world)
 {
-    if(mBody) world->DestroyBody(mBody);
+    if (mBody) {
+        if (mCoreWorld)
+            mCoreWorld->destroyBody(mBody);
+        else
+            world->DestroyBody(mBody);
+    }
+    foreach (Box2DLightFixture *fixture, mLightFixtures)
+        fixture->resetFixture();
     mBody = 0;
     mWorld = 0;
+    mCoreWorld = 0;
+    mAwakePending = false;
+}
+
+/**
+ * Moves the body to another world, recreating its b2Body there with the
+ * same state. Joints attached to the body are destroyed.
+ */
+void Box2DBody::moveTo(Box2DCoreWorld *world)
+{
+    if (!mBody || world == mCoreWorld)
+        return;
+
+    // The definition already holds the type, damping, flags and active
+    // state, only what the simulation changes is taken from the b2Body
+    mBodyDef.linearVelocity = mBody->GetLinearVelocity();
+    mBodyDef.angularVelocity = mBody->GetAngularVelocity();
+    mBodyDef.awake = awake();
+
+    // The new b2Body is created where the item is
+    synchronize();
+
+    mCoreWorld->releaseBody(this);
+    world->registerBody(this);
 }
 
 void Box2DBody::componentComplete()
@@ -547,7 +971,7 @@ void Box2DBody::componentComplete()
     QQuickItem::componentComplete();
 
     if (mInitializePending)
-        initialize(mWorld);
+        initialize(mCoreWorld);
 }
 
 
@@ -561,6 +985,11 @@ b2World *Box2DBody::world() const
     return mWorld;
 }
 
+Box2DCoreWorld *Box2DBody::coreWorld() const
+{
+    return mCoreWorld;
+}
+
 /*!
 \qmlsignal Body::geometryChanged(newGeometry,oldGeometry)
 A signal that can be used to gather geometry info.
@@ -572,7 +1001,13 @@ void Box2DBody::geometryChanged(const QRectF &newGeometry,
     if (!mSynchronizing && mBody) {
         if (newGeometry.x() != oldGeometry.x() || newGeometry.y() != oldGeometry.y())
         {
-            mBody->SetTransform(b2Vec2(newGeometry.x() / scaleRatio,-newGeometry.y() / scaleRatio),mBody->GetAngle());
+            mCoreWorld->setBodyTransform(this,
+                                          b2Vec2(newGeometry.x() / scaleRatio,
+                                                 -newGeometry.y() / scaleRatio),
+                                          (renderedRotation() * b2_pi) / -180.0);
+            if (mRenderTransform)
+                mRenderTransform->setOffset(0, 0, mRenderTransform->rotation());
+            wakeUpWorld();
         }
     }
     QQuickItem::geometryChanged(newGeometry, oldGeometry);
@@ -586,8 +1021,14 @@ A signal that can be used to tell if the rotation has changed
 void Box2DBody::onRotationChanged()
 {
     if (!mSynchronizing && mBody) {
-        mBody->SetTransform(mBody->GetPosition(),
-                            (rotation() * b2_pi) / -180.0);
+        mCoreWorld->setBodyTransform(this,
+                                      b2Vec2(renderedX() / scaleRatio,
+                                             -renderedY() / scaleRatio),
+                                      (rotation() * b2_pi) / -180.0);
+        if (mRenderTransform)
+            mRenderTransform->setOffset(mRenderTransform->x(),
+                                        mRenderTransform->y(), 0);
+        wakeUpWorld();
     }
 }
 
@@ -599,10 +1040,12 @@ void Box2DBody::applyLinearImpulse(const QPointF &impulse,
                                    const QPointF &point)
 {
     if (mBody) {
-        mBody->ApplyLinearImpulse(b2Vec2(impulse.x() / scaleRatio,
-                                         -impulse.y() / scaleRatio),
-                                  b2Vec2(point.x() / scaleRatio,
-                                         -point.y() / scaleRatio),true);
+        mCoreWorld->applyLinearImpulse(this,
+                                        b2Vec2(impulse.x() / scaleRatio,
+                                               -impulse.y() / scaleRatio),
+                                        b2Vec2(point.x() / scaleRatio,
+                                               -point.y() / scaleRatio));
+        wakeUpWorld();
     }
 }
 
@@ -612,8 +1055,10 @@ void Box2DBody::applyLinearImpulse(const QPointF &impulse,
  */
 void Box2DBody::applyTorque(qreal torque)
 {
-    if (mBody)
-        mBody->ApplyTorque(torque,true);
+    if (mBody) {
+        mCoreWorld->applyTorque(this, torque);
+        wakeUpWorld();
+    }
 }
 
 /*!
@@ -624,8 +1069,8 @@ void Box2DBody::applyTorque(qreal torque)
 QPointF Box2DBody::getWorldCenter() const
 {
     QPointF worldCenter;
-    if (mBody) {
-        const b2Vec2 &center = mBody->GetWorldCenter();
+    if (const b2Body *body = readableBody()) {
+        const b2Vec2 &center = body->GetWorldCenter();
         worldCenter.setX(center.x * scaleRatio);
         worldCenter.setY(-center.y * scaleRatio);
     }
@@ -640,10 +1085,12 @@ QPointF Box2DBody::getWorldCenter() const
 void Box2DBody::applyForce(const QPointF &force, const QPointF &point)
 {
     if (mBody) {
-        mBody->ApplyForce(b2Vec2(force.x() / scaleRatio,
-                                         -force.y() / scaleRatio),
-                                  b2Vec2(point.x() / scaleRatio,
-                                         -point.y() / scaleRatio),true);
+        mCoreWorld->applyForce(this,
+                                b2Vec2(force.x() / scaleRatio,
+                                       -force.y() / scaleRatio),
+                                b2Vec2(point.x() / scaleRatio,
+                                       -point.y() / scaleRatio));
+        wakeUpWorld();
     }
 }
 
@@ -651,28 +1098,28 @@ void Box2DBody::applyForce(const QPointF &force, const QPointF &point)
 
 float Box2DBody::getMass() const
 {
-    if (mBody)
-        return mBody->GetMass() * scaleRatio;
+    if (const b2Body *body = readableBody())
+        return body->GetMass() * scaleRatio;
     return 0.0;
 }
 
 float Box2DBody::GetInertia() const
 {
-    if(mBody)
-        return mBody->GetInertia();
+    if (const b2Body *body = readableBody())
+        return body->GetInertia();
     return 0.0;
 }
 
 QPointF Box2DBody::GetLinearVelocityFromWorldPoint(const QPointF &point)
 {
-    const b2Vec2 &b2Point = mBody->GetLinearVelocityFromWorldPoint(b2Vec2(point.x() / scaleRatio,
+    const b2Vec2 &b2Point = readableBody()->GetLinearVelocityFromWorldPoint(b2Vec2(point.x() / scaleRatio,
                                                   -point.y() / scaleRatio));
     return QPointF(b2Point.x * scaleRatio,-b2Point.y * scaleRatio);
 }
 
 QPointF Box2DBody::GetLinearVelocityFromLocalPoint(const QPointF &point)
 {
-    const b2Vec2 &b2Point = mBody->GetLinearVelocityFromLocalPoint(b2Vec2(point.x() / scaleRatio,
+    const b2Vec2 &b2Point = readableBody()->GetLinearVelocityFromLocalPoint(b2Vec2(point.x() / scaleRatio,
                                                   -point.y() / scaleRatio));
     return QPointF(b2Point.x * scaleRatio,-b2Point.y * scaleRatio);
 }
@@ -35,7 +35,9 @@
 #include <Box2D.h>
 
 class Box2DFixture;
-class Box2DWorld;
+class Box2DLightFixture;
+class Box2DCoreWorld;
+class Box2DBodyTransform;
 
 class b2Body;
 class b2BodyDef;
@@ -49,6 +51,8 @@ class Box2DBody : public QQuickItem
     Q_OBJECT
 
     Q_ENUMS(BodyType)
+    Q_ENUMS(ObservedProperty)
+    Q_FLAGS(ObservedProperties)
     Q_PROPERTY(qreal linearDamping READ linearDamping WRITE setLinearDamping NOTIFY linearDampingChanged)
     Q_PROPERTY(qreal angularDamping READ angularDamping WRITE setAngularDamping NOTIFY angularDampingChanged)
     Q_PROPERTY(BodyType bodyType READ bodyType WRITE setBodyType NOTIFY bodyTypeChanged)
@@ -56,9 +60,12 @@ class Box2DBody : public QQuickItem
     Q_PROPERTY(bool sleepingAllowed READ sleepingAllowed WRITE setSleepingAllowed NOTIFY sleepingAllowedChanged)
     Q_PROPERTY(bool fixedRotation READ fixedRotation WRITE setFixedRotation NOTIFY fixedRotationChanged)
     Q_PROPERTY(bool active READ active WRITE setActive)
-    Q_PROPERTY(bool awake READ awake WRITE setAwake)
+    Q_PROPERTY(bool awake READ awake WRITE setAwake NOTIFY awakeChanged)
     Q_PROPERTY(QPointF linearVelocity READ linearVelocity WRITE setLinearVelocity NOTIFY linearVelocityChanged)
+    Q_PROPERTY(qreal angularVelocity READ angularVelocity WRITE setAngularVelocity NOTIFY angularVelocityChanged)
+    Q_PROPERTY(ObservedProperties observedProperties READ observedProperties WRITE setObservedProperties NOTIFY observedPropertiesChanged)
     Q_PROPERTY(QQmlListProperty<Box2DFixture> fixtures READ fixtures)
+    Q_PROPERTY(QQmlListProperty<Box2DLightFixture> lightFixtures READ lightFixtures)
     Q_PROPERTY(qreal gravityScale READ gravityScale WRITE setGravityScale NOTIFY gravityScaleChanged)
 
 public:
@@ -68,6 +75,14 @@ public:
         Dynamic
     };
 
+    enum ObservedProperty {
+        LinearVelocity = 0x1,
+        AngularVelocity = 0x2,
+        Awake = 0x4
+    };
+
+    Q_DECLARE_FLAGS(ObservedProperties, ObservedProperty)
+
     explicit Box2DBody(QQuickItem *parent = 0);
     ~Box2DBody();
 
@@ -98,14 +113,33 @@ public:
     QPointF linearVelocity() const;
     void setLinearVelocity(const QPointF &_linearVelocity);
 
+    qreal angularVelocity() const;
+    void setAngularVelocity(qreal angularVelocity);
+
+    /**
+     * The dynamic properties that notify changes made by the simulation,
+     * checked once after each step. None by default.
+     */
+    ObservedProperties observedProperties() const { return mObservedProperties; }
+    void setObservedProperties(ObservedProperties observedProperties);
+
     qreal gravityScale() const;
     void setGravityScale(qreal _gravityScale);
 
     QQmlListProperty<Box2DFixture> fixtures();
+    QQmlListProperty<Box2DLightFixture> lightFixtures();
 
-    void initialize(b2World *world);
+    void initialize(Box2DCoreWorld *world);
     void synchronize();
+    void synchronize(const b2Vec2 &position, float32 angle);
+    void setTransforms(const b2Transform &previous, const b2Transform &current,
+                       float32 angle);
+    void interpolate(float32 alpha);
     void cleanup(b2World *world);
+    void moveTo(Box2DCoreWorld *world);
+    void setRenderOnly(bool renderOnly);
+
+    Q_INVOKABLE void commitTransform();
 
     Q_INVOKABLE void applyForce(const QPointF &force,const QPointF &point);
     Q_INVOKABLE void applyTorque(qreal torque);
@@ -119,6 +153,7 @@ public:
     void componentComplete();
     b2Body *body() const;
     b2World * world() const;
+    Box2DCoreWorld *coreWorld() const;
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
@@ -130,26 +165,64 @@ signals:
     void sleepingAllowedChanged();
     void fixedRotationChanged();
     void linearVelocityChanged();
+    void angularVelocityChanged();
+    void awakeChanged();
+    void observedPropertiesChanged();
     void bodyCreated();
     void gravityScaleChanged();
 
 private slots:
     void onRotationChanged();
 
+private:
+    friend class Box2DCoreWorld;
+
+    void createBody();
+    void adoptBody(Box2DCoreWorld *world, b2Body *body);
+    void resetTransforms();
+    void wakeUpWorld();
+    const b2Body *readableBody() const;
+    void storeObservedValues();
+    void emitObservedChanges();
+    qreal renderedX() const;
+    qreal renderedY() const;
+    qreal renderedRotation() const;
+
 private:
     b2Body *mBody;
     b2World *mWorld;
+    Box2DCoreWorld *mCoreWorld;
     b2BodyDef mBodyDef;
+    b2Transform mPreviousTransform;
+    b2Transform mTransform;
+    float32 mAngle;
     bool mSynchronizing;
     bool mInitializePending;
+    bool mOutsideFocus;
+    bool mDeactivatedByFocus;
     QList<Box2DFixture*> mFixtures;
+    QList<Box2DLightFixture*> mLightFixtures;
+    Box2DBodyTransform *mRenderTransform;
+    int mIndex;
 
     static void append_fixture(QQmlListProperty<Box2DFixture> *list,
                                Box2DFixture *fixture);
     static int count_fixture(QQmlListProperty<Box2DFixture> *list);
     static Box2DFixture * at_fixture(QQmlListProperty<Box2DFixture> *list,int index);
+    static void append_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                     Box2DLightFixture *fixture);
+    static int count_light_fixture(QQmlListProperty<Box2DLightFixture> *list);
+    static Box2DLightFixture *at_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                               int index);
     qreal mGravityScale;
+    ObservedProperties mObservedProperties;
+    b2Vec2 mObservedLinearVelocity;
+    float32 mObservedAngularVelocity;
+    bool mObservedAwake;
+    bool mAwakePending;
 
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Box2DBody::ObservedProperties)
+
 #endif // BOX2DBODY_H
@@ -0,0 +1,594 @@
+/*
+ * box2dbodyinstancer.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dbodyinstancer.h"
+
+#include "box2dlightbody.h"
+#include "box2dworld.h"
+#include "box2dcoreworld.h"
+
+#include <QAbstractItemModel>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QDebug>
+
+/*!
+    \qmltype BodyInstancer
+    \instantiates Box2DBodyInstancer
+    \inqmlmodule Box2D 1.1
+    \brief Creates a body for each row of a model.
+
+A BodyInstancer creates a body like its \l prototype for each row of a
+model, at the position and rotation given by the \l xRole, \l yRole and
+\l rotationRole of the row. When rows are inserted, changed or removed,
+only the bodies of those rows are created, moved or destroyed. The bodies
+are created as with World::createBodies(), so they are not objects and do
+not emit contact signals.
+
+A \l delegate item is only created for the bodies inside of the
+\l viewport. It follows its body after each step, and is reused for
+another body once its body leaves the viewport. The delegate can use
+\c index and the roles of its row, as in a Repeater.
+
+\code
+LightBody {
+    id: rock
+    lightFixtures: LightCircle { radius: 8 }
+}
+
+BodyInstancer {
+    world: world
+    model: levelModel
+    prototype: rock
+    viewport: Qt.rect(camera.x, camera.y, camera.width, camera.height)
+    delegate: Image { source: "rock.png" }
+}
+\endcode
+*/
+
+Box2DBodyInstancer::Box2DBodyInstancer(QObject *parent) :
+    QObject(parent),
+    mWorld(0),
+    mModel(0),
+    mPrototype(0),
+    mXRole(QLatin1String("x")),
+    mYRole(QLatin1String("y")),
+    mRotationRole(QLatin1String("rotation")),
+    mX(-1),
+    mY(-1),
+    mRotation(-1),
+    mDelegate(0),
+    mComponentComplete(false),
+    mDelegateCount(0)
+{
+}
+
+Box2DBodyInstancer::~Box2DBodyInstancer()
+{
+    clear();
+}
+
+/*!
+\qmlproperty World BodyInstancer::world
+The world the bodies are created in. The delegate items become children of
+it.
+*/
+void Box2DBodyInstancer::setWorld(Box2DWorld *world)
+{
+    if (mWorld == world)
+        return;
+
+    clear();
+    if (mWorld)
+        disconnect(mWorld, 0, this, 0);
+
+    mWorld = world;
+    if (mWorld) {
+        connect(mWorld, SIGNAL(stepped()), this, SLOT(updateDelegates()));
+        // An asynchronous world has no b2World until it is ready
+        connect(mWorld, SIGNAL(ready()), this, SLOT(reset()));
+    }
+    emit worldChanged();
+
+    reset();
+}
+
+/*!
+\qmlproperty QAbstractItemModel BodyInstancer::model
+The model with a row for each body.
+*/
+void Box2DBodyInstancer::setModel(QAbstractItemModel *model)
+{
+    if (mModel == model)
+        return;
+
+    clear();
+    if (mModel)
+        disconnect(mModel, 0, this, 0);
+
+    mModel = model;
+    if (mModel) {
+        connect(mModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                this, SLOT(onRowsInserted(QModelIndex,int,int)));
+        connect(mModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                this, SLOT(onRowsRemoved(QModelIndex,int,int)));
+        connect(mModel, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+                this, SLOT(onDataChanged(QModelIndex,QModelIndex,QVector<int>)));
+        connect(mModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+                this, SLOT(reset()));
+        connect(mModel, SIGNAL(layoutChanged()), this, SLOT(reset()));
+        connect(mModel, SIGNAL(modelReset()), this, SLOT(reset()));
+        connect(mModel, SIGNAL(destroyed()), this, SLOT(modelDestroyed()));
+    }
+    emit modelChanged();
+
+    reset();
+}
+
+/*!
+\qmlproperty LightBody BodyInstancer::prototype
+The body the bodies are created like: its type, damping and light fixtures.
+It should not be in a world itself.
+*/
+void Box2DBodyInstancer::setPrototype(Box2DLightBody *prototype)
+{
+    if (mPrototype == prototype)
+        return;
+
+    mPrototype = prototype;
+    emit prototypeChanged();
+
+    reset();
+}
+
+/*!
+\qmlproperty string BodyInstancer::xRole
+\qmlproperty string BodyInstancer::yRole
+\qmlproperty string BodyInstancer::rotationRole
+The roles holding the position in pixels and the rotation in degrees of the
+body of each row. "x", "y" and "rotation" by default. A role the model
+does not have is taken as 0.
+*/
+void Box2DBodyInstancer::setXRole(const QString &xRole)
+{
+    if (mXRole == xRole)
+        return;
+
+    mXRole = xRole;
+    emit xRoleChanged();
+
+    reset();
+}
+
+void Box2DBodyInstancer::setYRole(const QString &yRole)
+{
+    if (mYRole == yRole)
+        return;
+
+    mYRole = yRole;
+    emit yRoleChanged();
+
+    reset();
+}
+
+void Box2DBodyInstancer::setRotationRole(const QString &rotationRole)
+{
+    if (mRotationRole == rotationRole)
+        return;
+
+    mRotationRole = rotationRole;
+    emit rotationRoleChanged();
+
+    reset();
+}
+
+/*!
+\qmlproperty Component BodyInstancer::delegate
+The component of the items showing the bodies. Optional.
+*/
+void Box2DBodyInstancer::setDelegate(QQmlComponent *delegate)
+{
+    if (mDelegate == delegate)
+        return;
+
+    // Items of the previous delegate can not be reused
+    for (int i = 0; i < mInstances.count(); ++i)
+        releaseItem(mInstances[i]);
+    for (int i = 0; i < mFreeItems.count(); ++i) {
+        delete mFreeItems.at(i).first;
+        delete mFreeItems.at(i).second;
+    }
+    mFreeItems.clear();
+
+    mDelegate = delegate;
+    emit delegateChanged();
+
+    updateDelegates();
+}
+
+/*!
+\qmlproperty rect BodyInstancer::viewport
+The area of the world in which bodies get a delegate item. An empty
+rectangle, the default, gives every body an item.
+*/
+void Box2DBodyInstancer::setViewport(const QRectF &viewport)
+{
+    if (mViewport == viewport)
+        return;
+
+    mViewport = viewport;
+    emit viewportChanged();
+
+    updateDelegates();
+}
+
+/*!
+\qmlproperty int BodyInstancer::count
+The number of bodies, one for each row of the model.
+*/
+
+/*!
+\qmlproperty int BodyInstancer::delegateCount
+The number of delegate items currently showing a body.
+*/
+
+/*!
+\qmlmethod int BodyInstancer::handleAt(int row)
+The handle of the body of the given row, as with World::createBodies().
+*/
+int Box2DBodyInstancer::handleAt(int row) const
+{
+    if (row < 0 || row >= mInstances.count())
+        return -1;
+    return mInstances.at(row).handle;
+}
+
+/*!
+\qmlmethod Item BodyInstancer::itemAt(int row)
+The delegate item of the given row, or null when its body is outside of the
+viewport.
+*/
+QQuickItem *Box2DBodyInstancer::itemAt(int row) const
+{
+    if (row < 0 || row >= mInstances.count())
+        return 0;
+    return mInstances.at(row).item;
+}
+
+void Box2DBodyInstancer::classBegin()
+{
+}
+
+void Box2DBodyInstancer::componentComplete()
+{
+    mComponentComplete = true;
+    reset();
+}
+
+void Box2DBodyInstancer::onRowsInserted(const QModelIndex &parent,
+                                        int first, int last)
+{
+    if (parent.isValid() || !mComponentComplete || !mWorld || !mPrototype)
+        return;
+
+    createBodies(first, last);
+    for (int row = last + 1; row < mInstances.count(); ++row)
+        updateContext(row);
+
+    emit countChanged();
+    updateDelegates();
+}
+
+void Box2DBodyInstancer::onRowsRemoved(const QModelIndex &parent,
+                                       int first, int last)
+{
+    if (parent.isValid() || first >= mInstances.count())
+        return;
+
+    last = qMin(last, mInstances.count() - 1);
+    Box2DCoreWorld *core = mWorld ? mWorld->core() : 0;
+    for (int row = first; row <= last; ++row) {
+        releaseItem(mInstances[row]);
+        if (core)
+            core->destroyBodies(mInstances.at(row).handle, 1);
+    }
+    mInstances.remove(first, last - first + 1);
+
+    for (int row = first; row < mInstances.count(); ++row)
+        updateContext(row);
+
+    emit countChanged();
+    updateDelegates();
+}
+
+void Box2DBodyInstancer::onDataChanged(const QModelIndex &topLeft,
+                                       const QModelIndex &bottomRight,
+                                       const QVector<int> &roles)
+{
+    if (topLeft.parent().isValid() || !mWorld || mInstances.isEmpty())
+        return;
+
+    const bool moved = roles.isEmpty() || roles.contains(mX)
+            || roles.contains(mY) || roles.contains(mRotation);
+    const int last = qMin(bottomRight.row(), mInstances.count() - 1);
+    Box2DCoreWorld *core = mWorld->core();
+
+    for (int row = topLeft.row(); row <= last; ++row) {
+        if (moved) {
+            const QModelIndex index = mModel->index(row, 0);
+            const qreal x = mModel->data(index, mX).toReal();
+            const qreal y = mModel->data(index, mY).toReal();
+            const qreal rotation = mModel->data(index, mRotation).toReal();
+            core->setHandleTransform(mInstances.at(row).handle,
+                                     b2Vec2(x / scaleRatio, -y / scaleRatio),
+                                     (rotation * b2_pi) / -180.0);
+            core->wakeUp();
+        }
+        updateContext(row);
+    }
+
+    if (moved)
+        updateDelegates();
+}
+
+/**
+ * Recreates all bodies, for example when the model was reset.
+ */
+void Box2DBodyInstancer::reset()
+{
+    clear();
+
+    if (!mComponentComplete || !mWorld || !mModel || !mPrototype)
+        return;
+
+    resolveRoles();
+
+    const int rows = mModel->rowCount(QModelIndex());
+    if (rows > 0)
+        createBodies(0, rows - 1);
+
+    emit countChanged();
+    updateDelegates();
+}
+
+/**
+ * Drops the bodies of a model that is being destroyed. Unlike reset(), this
+ * does not call into the model, which is no longer fully alive.
+ */
+void Box2DBodyInstancer::modelDestroyed()
+{
+    mModel = 0;
+    clear();
+    emit modelChanged();
+}
+
+/**
+ * Destroys all bodies and delegate items.
+ */
+void Box2DBodyInstancer::clear()
+{
+    if (mInstances.isEmpty() && mFreeItems.isEmpty())
+        return;
+
+    Box2DCoreWorld *core = mWorld ? mWorld->core() : 0;
+    for (int i = 0; i < mInstances.count(); ++i) {
+        const Instance &instance = mInstances.at(i);
+        if (core)
+            core->destroyBodies(instance.handle, 1);
+        delete instance.item;
+        delete instance.context;
+    }
+    mInstances.clear();
+
+    for (int i = 0; i < mFreeItems.count(); ++i) {
+        delete mFreeItems.at(i).first;
+        delete mFreeItems.at(i).second;
+    }
+    mFreeItems.clear();
+
+    if (mDelegateCount != 0) {
+        mDelegateCount = 0;
+        emit delegateCountChanged();
+    }
+    emit countChanged();
+}
+
+void Box2DBodyInstancer::resolveRoles()
+{
+    mX = mY = mRotation = -1;
+
+    const QHash<int, QByteArray> roles = mModel->roleNames();
+    QHash<int, QByteArray>::const_iterator it = roles.constBegin();
+    for (; it != roles.constEnd(); ++it) {
+        const QString name = QString::fromLatin1(it.value());
+        if (name == mXRole)
+            mX = it.key();
+        else if (name == mYRole)
+            mY = it.key();
+        else if (name == mRotationRole)
+            mRotation = it.key();
+    }
+}
+
+/**
+ * Creates the bodies of the given rows with a single call to
+ * CoreWorld::createBodies(), and inserts them at those rows.
+ */
+void Box2DBodyInstancer::createBodies(int first, int last)
+{
+    const int count = last - first + 1;
+    QVector<float> positions(count * 2);
+    QVector<qreal> rotations(count);
+
+    for (int i = 0; i < count; ++i) {
+        const QModelIndex index = mModel->index(first + i, 0);
+        positions[i * 2] = mModel->data(index, mX).toReal();
+        positions[i * 2 + 1] = mModel->data(index, mY).toReal();
+        rotations[i] = mModel->data(index, mRotation).toReal();
+    }
+
+    Box2DCoreWorld *core = mWorld->core();
+    const int handle = core->createBodies(mPrototype, positions.constData(), count);
+    if (handle < 0)
+        return;
+
+    Instance instance;
+    instance.item = 0;
+    instance.context = 0;
+    mInstances.insert(first, count, instance);
+
+    for (int i = 0; i < count; ++i) {
+        mInstances[first + i].handle = handle + i;
+        if (rotations.at(i) != 0) {
+            core->setHandleTransform(handle + i,
+                                     b2Vec2(positions.at(i * 2) / scaleRatio,
+                                            -positions.at(i * 2 + 1) / scaleRatio),
+                                     (rotations.at(i) * b2_pi) / -180.0);
+        }
+    }
+}
+
+/**
+ * Exposes the index and the roles of the row to its delegate item.
+ */
+void Box2DBodyInstancer::updateContext(int row)
+{
+    QQmlContext *context = mInstances.at(row).context;
+    if (!context)
+        return;
+
+    const QModelIndex index = mModel->index(row, 0);
+    context->setContextProperty(QLatin1String("index"), row);
+
+    const QHash<int, QByteArray> roles = mModel->roleNames();
+    QHash<int, QByteArray>::const_iterator it = roles.constBegin();
+    for (; it != roles.constEnd(); ++it)
+        context->setContextProperty(QString::fromLatin1(it.value()),
+                                    mModel->data(index, it.key()));
+}
+
+/**
+ * Gives the bodies inside of the viewport a delegate item and moves it to
+ * the body, and takes the items of the bodies outside of it back.
+ */
+void Box2DBodyInstancer::updateDelegates()
+{
+    if (!mDelegate || !mWorld || mInstances.isEmpty())
+        return;
+
+    // Called for a changed viewport or model too, while a threaded step may
+    // be moving the bodies
+    Box2DCoreWorld *core = mWorld->core();
+    core->waitForStep();
+    int delegateCount = 0;
+
+    for (int row = 0; row < mInstances.count(); ++row) {
+        Instance &instance = mInstances[row];
+        const b2Body *body = core->handleBody(instance.handle);
+        if (!body) {
+            releaseItem(instance);
+            continue;
+        }
+
+        const b2Vec2 &position = body->GetPosition();
+        const QPointF point(position.x * scaleRatio, -position.y * scaleRatio);
+        if (!mViewport.isEmpty() && !mViewport.contains(point)) {
+            releaseItem(instance);
+            continue;
+        }
+
+        if (!instance.item) {
+            if (!acquireItem(instance))
+                break;
+            updateContext(row);
+        }
+
+        instance.item->setX(point.x());
+        instance.item->setY(point.y());
+        instance.item->setRotation((body->GetAngle() * -180.0) / b2_pi);
+        ++delegateCount;
+    }
+
+    if (mDelegateCount != delegateCount) {
+        mDelegateCount = delegateCount;
+        emit delegateCountChanged();
+    }
+}
+
+void Box2DBodyInstancer::releaseItem(Instance &instance)
+{
+    if (!instance.item)
+        return;
+
+    instance.item->setVisible(false);
+    mFreeItems.append(qMakePair(instance.item, instance.context));
+    instance.item = 0;
+    instance.context = 0;
+}
+
+/**
+ * Gives the instance a delegate item, reusing one that was released when
+ * possible.
+ */
+bool Box2DBodyInstancer::acquireItem(Instance &instance)
+{
+    if (!mFreeItems.isEmpty()) {
+        const QPair<QQuickItem*, QQmlContext*> free = mFreeItems.takeLast();
+        instance.item = free.first;
+        instance.context = free.second;
+        instance.item->setVisible(true);
+        return true;
+    }
+
+    QQmlContext *parentContext = mDelegate->creationContext();
+    if (!parentContext)
+        parentContext = qmlContext(this);
+
+    QQmlContext *context = new QQmlContext(parentContext, this);
+    QObject *object = mDelegate->beginCreate(context);
+    QQuickItem *item = qobject_cast<QQuickItem*>(object);
+    if (!item) {
+        if (mDelegate->isError())
+            qWarning() << "BodyInstancer:" << mDelegate->errorString();
+        else
+            qWarning() << "BodyInstancer: the root of the delegate is not an Item";
+        if (object) {
+            mDelegate->completeCreate();
+            delete object;
+        }
+        delete context;
+        return false;
+    }
+
+    QQmlEngine::setObjectOwnership(item, QQmlEngine::CppOwnership);
+    item->setParent(this);
+    item->setParentItem(mWorld);
+    item->setTransformOrigin(QQuickItem::TopLeft);
+    instance.item = item;
+    instance.context = context;
+    mDelegate->completeCreate();
+    return true;
+}
@@ -0,0 +1,182 @@
+/*
+ * box2dbodyinstancer.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DBODYINSTANCER_H
+#define BOX2DBODYINSTANCER_H
+
+#include <QObject>
+#include <QQmlParserStatus>
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include <QVector>
+#include <QRectF>
+#include <QString>
+#include <QModelIndex>
+
+class Box2DLightBody;
+class Box2DWorld;
+
+class QAbstractItemModel;
+class QQmlComponent;
+class QQmlContext;
+class QQuickItem;
+
+/**
+ * Creates a body for each row of a model, like the bodies created by
+ * World::createBodies(), and keeps them in line with the rows as they are
+ * inserted, changed and removed. Delegate items are only created for the
+ * bodies inside of the viewport, and are reused as bodies leave it.
+ */
+class Box2DBodyInstancer : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(Box2DWorld *world READ world WRITE setWorld NOTIFY worldChanged)
+    Q_PROPERTY(QAbstractItemModel *model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(Box2DLightBody *prototype READ prototype WRITE setPrototype NOTIFY prototypeChanged)
+    Q_PROPERTY(QString xRole READ xRole WRITE setXRole NOTIFY xRoleChanged)
+    Q_PROPERTY(QString yRole READ yRole WRITE setYRole NOTIFY yRoleChanged)
+    Q_PROPERTY(QString rotationRole READ rotationRole WRITE setRotationRole NOTIFY rotationRoleChanged)
+    Q_PROPERTY(QQmlComponent *delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
+    Q_PROPERTY(QRectF viewport READ viewport WRITE setViewport NOTIFY viewportChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int delegateCount READ delegateCount NOTIFY delegateCountChanged)
+
+public:
+    explicit Box2DBodyInstancer(QObject *parent = 0);
+    ~Box2DBodyInstancer();
+
+    Box2DWorld *world() const { return mWorld; }
+    void setWorld(Box2DWorld *world);
+
+    QAbstractItemModel *model() const { return mModel; }
+    void setModel(QAbstractItemModel *model);
+
+    /**
+     * The LightBody the bodies are created like. It should not be in a
+     * world itself.
+     */
+    Box2DLightBody *prototype() const { return mPrototype; }
+    void setPrototype(Box2DLightBody *prototype);
+
+    /**
+     * The roles holding the position in pixels and the rotation in degrees
+     * of the body of each row. "x", "y" and "rotation" by default.
+     */
+    QString xRole() const { return mXRole; }
+    void setXRole(const QString &xRole);
+
+    QString yRole() const { return mYRole; }
+    void setYRole(const QString &yRole);
+
+    QString rotationRole() const { return mRotationRole; }
+    void setRotationRole(const QString &rotationRole);
+
+    /**
+     * The component of the items showing the bodies. Optional.
+     */
+    QQmlComponent *delegate() const { return mDelegate; }
+    void setDelegate(QQmlComponent *delegate);
+
+    /**
+     * The area of the world in which bodies get a delegate item. An empty
+     * rectangle, the default, gives every body an item.
+     */
+    QRectF viewport() const { return mViewport; }
+    void setViewport(const QRectF &viewport);
+
+    /**
+     * The number of bodies, one for each row of the model.
+     */
+    int count() const { return mInstances.count(); }
+
+    /**
+     * The number of delegate items currently showing a body.
+     */
+    int delegateCount() const { return mDelegateCount; }
+
+    Q_INVOKABLE int handleAt(int row) const;
+    Q_INVOKABLE QQuickItem *itemAt(int row) const;
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void worldChanged();
+    void modelChanged();
+    void prototypeChanged();
+    void xRoleChanged();
+    void yRoleChanged();
+    void rotationRoleChanged();
+    void delegateChanged();
+    void viewportChanged();
+    void countChanged();
+    void delegateCountChanged();
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onDataChanged(const QModelIndex &topLeft,
+                       const QModelIndex &bottomRight,
+                       const QVector<int> &roles);
+    void reset();
+    void modelDestroyed();
+    void updateDelegates();
+
+private:
+    /**
+     * The body of a row and the item showing it, if any.
+     */
+    struct Instance {
+        int handle;
+        QQuickItem *item;
+        QQmlContext *context;
+    };
+
+    void clear();
+    void resolveRoles();
+    void createBodies(int first, int last);
+    void updateContext(int row);
+    void releaseItem(Instance &instance);
+    bool acquireItem(Instance &instance);
+
+    QPointer<Box2DWorld> mWorld;
+    QAbstractItemModel *mModel;
+    Box2DLightBody *mPrototype;
+    QString mXRole;
+    QString mYRole;
+    QString mRotationRole;
+    int mX;
+    int mY;
+    int mRotation;
+    QQmlComponent *mDelegate;
+    QRectF mViewport;
+    bool mComponentComplete;
+    int mDelegateCount;
+    QVector<Instance> mInstances;
+    QList<QPair<QQuickItem*, QQmlContext*> > mFreeItems;
+};
+
+#endif // BOX2DBODYINSTANCER_H
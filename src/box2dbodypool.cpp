@@ -0,0 +1,285 @@
+/*
+ * box2dbodypool.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dbodypool.h"
+
+#include "box2dbody.h"
+#include "box2dworld.h"
+
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QDebug>
+
+/*!
+    \qmltype BodyPool
+    \instantiates Box2DBodyPool
+    \inqmlmodule Box2D 1.1
+    \brief Reuses bodies instead of creating and destroying them.
+
+A BodyPool creates \l size bodies from its \l delegate ahead of time. The
+bodies are handed out by acquire() and taken back by release(), which is
+much cheaper than creating them with Component.createObject and destroying
+them again. Use it for bullets, debris and other bodies that come and go
+all the time.
+
+A body that is not in use is hidden and its b2Body is inactive, so it is
+not simulated and does not collide. Acquiring it moves it to where it is
+needed and activates it again.
+
+\code
+BodyPool {
+    id: bullets
+    world: world
+    size: 100
+    delegate: Bullet {}
+}
+
+function fire(x, y) {
+    var bullet = bullets.acquire({ x: x, y: y });
+    bullet.linearVelocity = Qt.point(0, -600);
+}
+
+// When the bullet hits something
+bullets.release(bullet);
+\endcode
+*/
+
+Box2DBodyPool::Box2DBodyPool(QObject *parent) :
+    QObject(parent),
+    mWorld(0),
+    mDelegate(0),
+    mSize(0),
+    mComponentComplete(false)
+{
+}
+
+Box2DBodyPool::~Box2DBodyPool()
+{
+    deleteBodies();
+}
+
+/*!
+\qmlproperty World BodyPool::world
+The world the bodies are created in.
+*/
+void Box2DBodyPool::setWorld(Box2DWorld *world)
+{
+    if (mWorld == world)
+        return;
+
+    deleteBodies();
+    mWorld = world;
+    emit worldChanged();
+
+    fill();
+}
+
+/*!
+\qmlproperty Component BodyPool::delegate
+The component the bodies are created from. Its root object needs to be a
+\l Body.
+*/
+void Box2DBodyPool::setDelegate(QQmlComponent *delegate)
+{
+    if (mDelegate == delegate)
+        return;
+
+    deleteBodies();
+    mDelegate = delegate;
+    emit delegateChanged();
+
+    fill();
+}
+
+/*!
+\qmlproperty int BodyPool::size
+The number of bodies created ahead of time. When more bodies are acquired
+at once, the pool creates additional ones and keeps them. Reducing the size
+deletes bodies that are not in use.
+*/
+void Box2DBodyPool::setSize(int size)
+{
+    size = qMax(0, size);
+    if (mSize == size)
+        return;
+
+    mSize = size;
+    emit sizeChanged();
+
+    fill();
+}
+
+/*!
+\qmlproperty int BodyPool::available
+The number of bodies that can be acquired without creating one.
+*/
+
+/*!
+\qmlmethod Body BodyPool::acquire(properties)
+Hands out a body that is not in use, after setting the given properties
+on it, typically x, y and rotation. Creates a new body when none is
+available.
+*/
+Box2DBody *Box2DBodyPool::acquire(const QVariantMap &properties)
+{
+    Box2DBody *body = mFree.isEmpty() ? createBody() : mFree.takeLast();
+    if (!body)
+        return 0;
+
+    QVariantMap::const_iterator it = properties.constBegin();
+    for (; it != properties.constEnd(); ++it)
+        body->setProperty(it.key().toLatin1().constData(), it.value());
+
+    body->setVisible(true);
+    body->setActive(true);
+    body->setAwake(true);
+
+    emit availableChanged();
+    return body;
+}
+
+/*!
+\qmlmethod BodyPool::release(body)
+Takes back a body handed out by acquire(). The body is hidden and
+deactivated and its velocity is cleared.
+*/
+void Box2DBodyPool::release(Box2DBody *body)
+{
+    if (!body || !mBodies.contains(body) || mFree.contains(body)) {
+        qWarning() << "BodyPool: released a body that is not in use";
+        return;
+    }
+
+    body->setActive(false);
+    body->setVisible(false);
+    body->setLinearVelocity(QPointF());
+    body->setAngularVelocity(0);
+
+    mFree.append(body);
+    emit availableChanged();
+}
+
+void Box2DBodyPool::classBegin()
+{
+}
+
+void Box2DBodyPool::componentComplete()
+{
+    mComponentComplete = true;
+    fill();
+}
+
+void Box2DBodyPool::bodyDestroyed(QObject *object)
+{
+    Box2DBody *body = static_cast<Box2DBody*>(object);
+    mBodies.removeAll(body);
+    if (mFree.removeAll(body))
+        emit availableChanged();
+}
+
+/**
+ * Creates bodies until there are as many as the size, or deletes unused
+ * ones when there are more.
+ */
+void Box2DBodyPool::fill()
+{
+    if (!mComponentComplete || !mWorld || !mDelegate)
+        return;
+
+    const int available = mFree.count();
+
+    while (mBodies.count() > mSize && !mFree.isEmpty()) {
+        Box2DBody *body = mFree.takeLast();
+        mBodies.removeAll(body);
+        disconnect(body, SIGNAL(destroyed(QObject*)),
+                   this, SLOT(bodyDestroyed(QObject*)));
+        delete body;
+    }
+
+    while (mBodies.count() < mSize) {
+        Box2DBody *body = createBody();
+        if (!body)
+            break;
+        mFree.append(body);
+    }
+
+    if (mFree.count() != available)
+        emit availableChanged();
+}
+
+/**
+ * Creates a body from the delegate, hidden and with an inactive b2Body.
+ */
+Box2DBody *Box2DBodyPool::createBody()
+{
+    if (!mWorld || !mDelegate)
+        return 0;
+
+    QQmlContext *context = mDelegate->creationContext();
+    if (!context)
+        context = qmlContext(this);
+
+    QObject *object = mDelegate->beginCreate(context);
+    Box2DBody *body = qobject_cast<Box2DBody*>(object);
+    if (!body) {
+        if (mDelegate->isError())
+            qWarning() << "BodyPool:" << mDelegate->errorString();
+        else
+            qWarning() << "BodyPool: the root of the delegate is not a Body";
+        if (object) {
+            mDelegate->completeCreate();
+            delete object;
+        }
+        return 0;
+    }
+
+    QQmlEngine::setObjectOwnership(body, QQmlEngine::CppOwnership);
+    body->setParent(this);
+    body->setActive(false);
+    body->setVisible(false);
+    body->setParentItem(mWorld);
+    mDelegate->completeCreate();
+
+    connect(body, SIGNAL(destroyed(QObject*)),
+            this, SLOT(bodyDestroyed(QObject*)));
+    mBodies.append(body);
+    return body;
+}
+
+void Box2DBodyPool::deleteBodies()
+{
+    if (mBodies.isEmpty())
+        return;
+
+    foreach (Box2DBody *body, mBodies) {
+        disconnect(body, SIGNAL(destroyed(QObject*)),
+                   this, SLOT(bodyDestroyed(QObject*)));
+        delete body;
+    }
+    mBodies.clear();
+    mFree.clear();
+
+    emit availableChanged();
+}
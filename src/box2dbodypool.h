@@ -0,0 +1,109 @@
+/*
+ * box2dbodypool.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DBODYPOOL_H
+#define BOX2DBODYPOOL_H
+
+#include <QObject>
+#include <QQmlParserStatus>
+#include <QList>
+#include <QVariant>
+
+class Box2DBody;
+class Box2DWorld;
+
+class QQmlComponent;
+
+/**
+ * Bodies created ahead of time from one component, handed out and taken
+ * back instead of being created and destroyed. A body that is not in use
+ * is hidden and its b2Body is inactive, so it costs nothing in the steps.
+ */
+class Box2DBodyPool : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(Box2DWorld *world READ world WRITE setWorld NOTIFY worldChanged)
+    Q_PROPERTY(QQmlComponent *delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
+    Q_PROPERTY(int size READ size WRITE setSize NOTIFY sizeChanged)
+    Q_PROPERTY(int available READ available NOTIFY availableChanged)
+
+public:
+    explicit Box2DBodyPool(QObject *parent = 0);
+    ~Box2DBodyPool();
+
+    /**
+     * The world the bodies are created in. They become children of it.
+     */
+    Box2DWorld *world() const { return mWorld; }
+    void setWorld(Box2DWorld *world);
+
+    /**
+     * The component the bodies are created from. Its root object needs to
+     * be a Body.
+     */
+    QQmlComponent *delegate() const { return mDelegate; }
+    void setDelegate(QQmlComponent *delegate);
+
+    /**
+     * The number of bodies created ahead of time. The pool grows beyond it
+     * when more bodies are acquired at once. 0 by default.
+     */
+    int size() const { return mSize; }
+    void setSize(int size);
+
+    /**
+     * The number of bodies that can be acquired without creating one.
+     */
+    int available() const { return mFree.count(); }
+
+    Q_INVOKABLE Box2DBody *acquire(const QVariantMap &properties = QVariantMap());
+    Q_INVOKABLE void release(Box2DBody *body);
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void worldChanged();
+    void delegateChanged();
+    void sizeChanged();
+    void availableChanged();
+
+private slots:
+    void bodyDestroyed(QObject *object);
+
+private:
+    void fill();
+    Box2DBody *createBody();
+    void deleteBodies();
+
+    Box2DWorld *mWorld;
+    QQmlComponent *mDelegate;
+    int mSize;
+    bool mComponentComplete;
+    QList<Box2DBody*> mBodies;
+    QList<Box2DBody*> mFree;
+};
+
+#endif // BOX2DBODYPOOL_H
@@ -0,0 +1,2360 @@
+/*
+ * box2dcoreworld.cpp
+ * Copyright (c) 2010-2011 Thorbjørn Lindeijer <thorbjorn@lindeijer.nl>
+ * Copyright (c) 2011 Joonas Erkinheimo <joonas.erkinheimo@nokia.com>
+ * Copyright (c) 2012 Adriano Rezende <atdrez@gmail.com>
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dcoreworld.h"
+
+#include "box2dbody.h"
+#include "box2dfixture.h"
+#include "box2dlightbody.h"
+#include "box2dlightfixture.h"
+#include "box2djoint.h"
+#include "box2ddestructionlistener.h"
+#include "box2dscheduler.h"
+
+#include <QTimerEvent>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QDebug>
+
+#include <string.h>
+
+#include <Box2D.h>
+
+class ContactEvent
+{
+public:
+    enum Type {
+        BeginContact,
+        EndContact
+    };
+
+    Type type;
+    Box2DFixture *fixtureA;
+    Box2DFixture *fixtureB;
+};
+
+/*!
+\class ContactListener
+*/
+class ContactListener : public b2ContactListener
+{
+public:
+    void BeginContact(b2Contact *contact);
+    void EndContact(b2Contact *contact);
+
+    void removeFixture(Box2DFixture *fixture);
+    void clearEvents() { mEvents.clear(); }
+    const QList<ContactEvent> &events() { return mEvents; }
+
+private:
+    QList<ContactEvent> mEvents;
+};
+
+void ContactListener::BeginContact(b2Contact *contact)
+{
+    ContactEvent event;
+    event.type = ContactEvent::BeginContact;
+    event.fixtureA = toBox2DFixture(contact->GetFixtureA());
+    event.fixtureB = toBox2DFixture(contact->GetFixtureB());
+    mEvents.append(event);
+}
+
+void ContactListener::EndContact(b2Contact *contact)
+{
+    ContactEvent event;
+    event.type = ContactEvent::EndContact;
+    event.fixtureA = toBox2DFixture(contact->GetFixtureA());
+    event.fixtureB = toBox2DFixture(contact->GetFixtureB());
+    mEvents.append(event);
+}
+
+/**
+ * Clears the fixture from the pending events, which are then skipped. The
+ * events are not removed, since they may be in the middle of being emitted.
+ */
+void ContactListener::removeFixture(Box2DFixture *fixture)
+{
+    for (int i = 0; i < mEvents.count(); ++i) {
+        ContactEvent &event = mEvents[i];
+        if (event.fixtureA == fixture || event.fixtureB == fixture) {
+            event.fixtureA = 0;
+            event.fixtureB = 0;
+        }
+    }
+}
+
+/*!
+\class FixtureCollector
+Collects the fixtures found by a query of the world.
+*/
+class FixtureCollector : public b2QueryCallback
+{
+public:
+    bool ReportFixture(b2Fixture *fixture)
+    {
+        fixtures.append(fixture);
+        return true;
+    }
+
+    QList<b2Fixture*> fixtures;
+};
+
+/**
+ * Applies the parts of a body definition that can change after the b2Body
+ * was created. Returns whether the type changed, which changes the
+ * contacts of the body.
+ */
+static bool updateBodyFromDef(b2Body *body, const b2BodyDef &def,
+                              float32 gravityScale)
+{
+    bool typeChanged = false;
+    if (body->GetType() != def.type) {
+        body->SetType(def.type);
+        typeChanged = true;
+    }
+    if (body->GetLinearDamping() != def.linearDamping)
+        body->SetLinearDamping(def.linearDamping);
+    if (body->GetAngularDamping() != def.angularDamping)
+        body->SetAngularDamping(def.angularDamping);
+    if (body->GetGravityScale() != gravityScale)
+        body->SetGravityScale(gravityScale);
+    if (body->IsBullet() != def.bullet)
+        body->SetBullet(def.bullet);
+    if (body->IsSleepingAllowed() != def.allowSleep)
+        body->SetSleepingAllowed(def.allowSleep);
+    if (body->IsFixedRotation() != def.fixedRotation)
+        body->SetFixedRotation(def.fixedRotation);
+    return typeChanged;
+}
+
+/**
+ * Applies the material and sensor flag of a fixture definition. The mass of
+ * the body follows a change of the density.
+ */
+static void updateFixtureFromDef(b2Fixture *fixture, const b2FixtureDef &def)
+{
+    if (fixture->GetDensity() != def.density) {
+        fixture->SetDensity(def.density);
+        fixture->GetBody()->ResetMassData();
+    }
+    fixture->SetFriction(def.friction);
+    fixture->SetRestitution(def.restitution);
+    if (fixture->IsSensor() != def.isSensor)
+        fixture->SetSensor(def.isSensor);
+}
+
+/*!
+\class StepJob
+Runs a single step of a threaded world on its physics thread.
+*/
+class StepJob : public QRunnable
+{
+public:
+    StepJob(Box2DCoreWorld *world, int steps) : mWorld(world), mSteps(steps) {}
+
+    void run()
+    {
+        mWorld->runStep(mSteps);
+        QMetaObject::invokeMethod(mWorld, "stepFinished", Qt::QueuedConnection);
+    }
+
+private:
+    Box2DCoreWorld *mWorld;
+    int mSteps;
+};
+
+struct Box2DCoreWorld::WorldBuild
+{
+    struct Fixture {
+        QPointer<Box2DFixture> fixture;
+        QPointer<Box2DLightFixture> lightFixture;
+        b2FixtureDef fixtureDef;
+        b2Shape *shape;
+        QVector<b2Vec2> hull;
+        b2Fixture *b2fixture;
+    };
+
+    struct Body {
+        QPointer<Box2DBody> body;
+        b2BodyDef bodyDef;
+        QVector<Fixture> fixtures;
+        b2Body *b2body;
+    };
+
+    WorldBuild() : world(0) {}
+    ~WorldBuild();
+
+    void run();
+
+    b2Vec2 gravity;
+    QVector<Body> bodies;
+    b2World *world;
+};
+
+Box2DCoreWorld::WorldBuild::~WorldBuild()
+{
+    foreach (const Body &body, bodies) {
+        foreach (const Fixture &fixture, body.fixtures)
+            delete fixture.shape;
+    }
+    delete world;
+}
+
+/**
+ * Creates the b2World, the b2Bodies and their b2Fixtures, computing the
+ * convex hulls of the polygons. Runs on the worker thread, so it only
+ * touches the definitions and never the wrappers.
+ */
+void Box2DCoreWorld::WorldBuild::run()
+{
+    world = new b2World(gravity);
+
+    for (int i = 0; i < bodies.count(); ++i) {
+        Body &body = bodies[i];
+        body.b2body = world->CreateBody(&body.bodyDef);
+
+        for (int j = 0; j < body.fixtures.count(); ++j) {
+            Fixture &fixture = body.fixtures[j];
+            if (!fixture.hull.isEmpty()) {
+                static_cast<b2PolygonShape*>(fixture.shape)->Set(fixture.hull.constData(),
+                                                                 fixture.hull.count());
+            }
+            fixture.fixtureDef.shape = fixture.shape;
+            fixture.b2fixture = body.b2body->CreateFixture(&fixture.fixtureDef);
+        }
+    }
+}
+
+/*!
+\class BuildJob
+Builds the b2World of an asynchronous world on its worker thread.
+*/
+class BuildJob : public QRunnable
+{
+public:
+    explicit BuildJob(Box2DCoreWorld *world) : mWorld(world) {}
+
+    void run()
+    {
+        mWorld->mBuild->run();
+        QMetaObject::invokeMethod(mWorld, "finishBuild", Qt::QueuedConnection);
+    }
+
+private:
+    Box2DCoreWorld *mWorld;
+};
+
+
+/*!
+    \qmltype CoreWorld
+    \instantiates Box2DCoreWorld
+    \inqmlmodule Box2D 1.1
+    \brief A World that does not need a window or a scene.
+
+CoreWorld runs the same simulation as \l World, with the same stepping,
+body management and contact signals, but it is not an item. It works in an
+application that only has a QCoreApplication, for example the
+authoritative server of a networked game.
+
+CoreWorld has the properties of World, except for the ones that depend on
+a window: steppingMode, maxSubSteps, droppedTime, interpolating,
+hiddenPolicy and maxCatchUpTime. It is always stepped by its timer, or by
+the scheduler when it is shared. Bodies are declared inside of it.
+
+\code
+CoreWorld {
+    gravity: Qt.point(0, 10)
+
+    Body {
+        bodyType: Body.Dynamic
+        fixtures: Circle { radius: 8; density: 1 }
+    }
+}
+\endcode
+*/
+/*!
+\class Box2DCoreWorld
+*/
+Box2DCoreWorld::Box2DCoreWorld(QObject *parent) :
+    QObject(parent),
+    mWorld(0),
+    mContactListener(new ContactListener),
+    mDestructionListener(new Box2DDestructionListener),
+    mTimeStep(1.0f / 60.0f),
+    mVelocityIterations(10),
+    mPositionIterations(10),
+    mFrameTime(1000 / 60),
+    mGravity(qreal(0), qreal(10)),
+    mIsRunning(true),
+    mComponentComplete(false),
+    mThreaded(false),
+    mShared(false),
+    mStepPending(false),
+    mCompletedSteps(0),
+    mStepPool(0),
+    mExternalStepping(false),
+    mPaused(false),
+    mInterpolating(false),
+    mSuspendWhenIdle(false),
+    mIdle(false),
+    mAwakeBodyCount(0),
+    mDispatching(false),
+    mOutsideFocusPolicy(Deactivate),
+    mReducedRateInterval(4),
+    mFullRateBodyCount(0),
+    mReducedRateBodyCount(0),
+    mStepCount(0),
+    mRollbackFrames(0),
+    mHistoryHead(0),
+    mHistoryCount(0),
+    mDeterministic(false),
+    mStateHash(0),
+    mOutsideBodyCount(0),
+    mSynchronizedBodyCount(0),
+    mRenderOnlyTransforms(false),
+    mPropertyUpdateInterval(0),
+    mAsynchronous(false),
+    mBuild(0),
+    mBuildPool(0)
+{
+    connect(mDestructionListener, SIGNAL(fixtureDestroyed(Box2DFixture*)),
+            this, SLOT(fixtureDestroyed(Box2DFixture*)));
+}
+
+Box2DCoreWorld::~Box2DCoreWorld()
+{
+    if (mShared)
+        Box2DScheduler::instance()->unregisterWorld(this);
+    waitForStep();
+    mStepPending = false;
+
+    if (mBuildPool)
+        mBuildPool->waitForDone();
+    delete mBuild;
+    mBuild = 0;
+
+    // Bodies must be deleted before the world
+    foreach (Box2DBody *body, mBodies)
+    {
+        if(body->parent() == this)
+            delete body;
+        else
+            body->cleanup(this->world());
+
+    }
+    mBodies.clear();
+    discardCommands();
+
+    qDeleteAll(mHistory);
+    delete mWorld;
+    delete mContactListener;
+    delete mDestructionListener;
+}
+
+void Box2DCoreWorld::setRunning(bool running)
+{
+    if (mIsRunning == running)
+        return;
+
+    mIsRunning = running;
+    emit runningChanged();
+
+    updateStepping();
+}
+
+void Box2DCoreWorld::setGravity(const QPointF &gravity)
+{
+    if (mGravity == gravity)
+        return;
+
+    mGravity = gravity;
+    if (mWorld) {
+        Command command(Command::SetGravity);
+        command.vector.Set(gravity.x(), -gravity.y());
+        submit(command);
+        wakeUp();
+    }
+
+    emit gravityChanged();
+}
+
+void Box2DCoreWorld::setThreaded(bool threaded)
+{
+    if (mThreaded == threaded)
+        return;
+
+    waitForStep();
+    mThreaded = threaded;
+
+    if (mThreaded && !mStepPool) {
+        mStepPool = new QThreadPool(this);
+        mStepPool->setMaxThreadCount(1);
+        mStepPool->setExpiryTimeout(-1);
+    }
+
+    emit threadedChanged();
+}
+
+void Box2DCoreWorld::setShared(bool shared)
+{
+    if (mShared == shared)
+        return;
+
+    waitForStep();
+    mShared = shared;
+    emit sharedChanged();
+
+    updateStepping();
+}
+
+void Box2DCoreWorld::setSuspendWhenIdle(bool suspendWhenIdle)
+{
+    if (mSuspendWhenIdle == suspendWhenIdle)
+        return;
+
+    mSuspendWhenIdle = suspendWhenIdle;
+    emit suspendWhenIdleChanged();
+
+    if (!mSuspendWhenIdle)
+        wakeUp();
+}
+
+/**
+ * Resumes stepping when the world is idle. Called whenever a body may have
+ * been woken up.
+ */
+void Box2DCoreWorld::wakeUp()
+{
+    if (!mIdle)
+        return;
+
+    mIdle = false;
+    emit idleChanged();
+
+    updateStepping();
+}
+
+void Box2DCoreWorld::setExternalStepping(bool externalStepping)
+{
+    if (mExternalStepping == externalStepping)
+        return;
+
+    mExternalStepping = externalStepping;
+    updateStepping();
+}
+
+void Box2DCoreWorld::setPaused(bool paused)
+{
+    if (mPaused == paused)
+        return;
+
+    mPaused = paused;
+    updateStepping();
+}
+
+void Box2DCoreWorld::setInterpolating(bool interpolating)
+{
+    mInterpolating = interpolating;
+}
+
+void Box2DCoreWorld::setFocusRect(const QRectF &focusRect)
+{
+    if (mFocusRect == focusRect)
+        return;
+
+    mFocusRect = focusRect;
+    emit focusRectChanged();
+
+    refocus();
+}
+
+void Box2DCoreWorld::setOutsideFocusPolicy(OutsideFocusPolicy outsideFocusPolicy)
+{
+    if (mOutsideFocusPolicy == outsideFocusPolicy)
+        return;
+
+    mOutsideFocusPolicy = outsideFocusPolicy;
+    emit outsideFocusPolicyChanged();
+
+    refocus();
+}
+
+void Box2DCoreWorld::setReducedRateInterval(int reducedRateInterval)
+{
+    reducedRateInterval = qMax(1, reducedRateInterval);
+    if (mReducedRateInterval == reducedRateInterval)
+        return;
+
+    mReducedRateInterval = reducedRateInterval;
+    emit reducedRateIntervalChanged();
+}
+
+void Box2DCoreWorld::setRollbackFrames(int rollbackFrames)
+{
+    rollbackFrames = qMax(0, rollbackFrames);
+    if (mRollbackFrames == rollbackFrames)
+        return;
+
+    // The physics thread may be saving a state
+    waitForStep();
+
+    qDeleteAll(mHistory);
+    mHistory.clear();
+
+    mRollbackFrames = rollbackFrames;
+    if (mRollbackFrames > 0) {
+        // One more than the number of frames, for the current state
+        mHistory.resize(mRollbackFrames + 1);
+        for (int i = 0; i < mHistory.count(); ++i)
+            mHistory[i] = new b2WorldState;
+    }
+    mHistoryHead = 0;
+    mHistoryCount = 0;
+
+    emit rollbackFramesChanged();
+}
+
+/*!
+  \qmlproperty bool CoreWorld::deterministic
+  Makes the world step to bit-identical results on every machine running
+  the same binary, given the same bodies and the same inputs, as needed
+  for lockstep multiplayer games.
+
+  Box2D normally processes contacts in the order in which its broad-phase
+  finds them, which depends on the history of the world. In deterministic
+  mode they are kept in the order in which their fixtures were created
+  instead. The Deactivate outsideFocusPolicy is ignored, since it depends
+  on what each player is looking at. Bodies need to be created in the same
+  order everywhere. False by default.
+
+  \sa stateHash
+*/
+void Box2DCoreWorld::setDeterministic(bool deterministic)
+{
+    if (mDeterministic == deterministic)
+        return;
+
+    waitForStep();
+    mDeterministic = deterministic;
+    if (mWorld)
+        mWorld->SetDeterministic(deterministic);
+
+    emit deterministicChanged();
+
+    if (!mDeterministic)
+        mStateHash = 0;
+    refocus();
+}
+
+/*!
+  \qmlproperty string CoreWorld::stateHash
+  A 64-bit hash of the positions and velocities of all bodies, computed
+  after each step in deterministic mode, as 16 hexadecimal digits. Peers
+  can compare it every frame to find out when their simulations diverge.
+  It is a string because JavaScript numbers cannot hold 64-bit integers.
+*/
+QString Box2DCoreWorld::stateHashString() const
+{
+    return QString::number(mStateHash, 16).rightJustified(16, QLatin1Char('0'));
+}
+
+static inline quint64 hashValue(quint64 hash, float32 value)
+{
+    quint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (hash ^ bits) * Q_UINT64_C(1099511628211);
+}
+
+/**
+ * Hashes the bits of the body states with FNV-1a, a word at a time. Runs on
+ * the physics thread in threaded mode.
+ */
+quint64 Box2DCoreWorld::computeStateHash() const
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+
+    for (const b2Body *b = mWorld->GetBodyList(); b; b = b->GetNext()) {
+        const b2Transform &transform = b->GetTransform();
+        const b2Vec2 &velocity = b->GetLinearVelocity();
+        hash = hashValue(hash, transform.p.x);
+        hash = hashValue(hash, transform.p.y);
+        hash = hashValue(hash, transform.q.s);
+        hash = hashValue(hash, transform.q.c);
+        hash = hashValue(hash, velocity.x);
+        hash = hashValue(hash, velocity.y);
+        hash = hashValue(hash, b->GetAngularVelocity());
+    }
+
+    return hash;
+}
+
+/*!
+  \qmlmethod bool CoreWorld::rewind(int steps)
+  Takes the world back to how it was the given number of steps ago, as
+  kept by rollbackFrames. Returns false when not that many steps are kept.
+
+  The bodies, their contacts and the joints are restored in place, without
+  creating or destroying any item, and stepping on from there gives the
+  same results as the first time. This is what rollback netcode needs: when
+  a late input arrives, rewind to the step it belongs to, apply it and step
+  forward again with advance().
+
+  Everything that was done to the world in between is undone, including
+  forces and impulses. Contact signals are not emitted for contacts that
+  are undone. The history is cleared when bodies, fixtures or joints are
+  created, destroyed, reshaped or (de)activated, since a state can only be
+  restored onto the same objects. When called while a threaded step is
+  running, that step is finished first and counted. Returns false when
+  called from the signal handlers of a step, since the world would go on
+  from the state before the rewind.
+
+\code
+CoreWorld {
+    id: world
+    rollbackFrames: 8
+    running: false
+}
+
+function onLateInput(input) {
+    var steps = currentFrame - input.frame
+    if (world.rewind(steps)) {
+        applyInput(input)
+        world.advance(steps)
+    }
+}
+\endcode
+*/
+bool Box2DCoreWorld::rewind(int steps)
+{
+    if (!mWorld || steps < 0)
+        return false;
+
+    if (mDispatching) {
+        qWarning() << "CoreWorld: Cannot rewind from the signal handlers of a step";
+        return false;
+    }
+
+    // Otherwise the rewind would be queued behind the running step, and the
+    // advance() that follows would be skipped
+    completeStep();
+    if (steps >= mHistoryCount)
+        return false;
+
+    Command command(Command::Rewind);
+    command.steps = steps;
+    submit(command);
+    return true;
+}
+
+/**
+ * Keeps the state after a step in the rollback history. Runs on the
+ * physics thread in threaded mode.
+ */
+void Box2DCoreWorld::saveState()
+{
+    if (mHistory.isEmpty())
+        return;
+
+    mHistoryHead = (mHistoryHead + 1) % mHistory.count();
+    mWorld->SaveState(mHistory.at(mHistoryHead));
+    mHistoryCount = qMin(mHistoryCount + 1, mHistory.count());
+}
+
+/**
+ * Restores the state of the given number of steps ago and drops the newer
+ * states from the history.
+ */
+void Box2DCoreWorld::restoreState(int steps)
+{
+    if (steps >= mHistoryCount) {
+        qWarning() << "CoreWorld: Cannot rewind" << steps << "steps, the history was cleared";
+        return;
+    }
+
+    const int index = (mHistoryHead - steps + mHistory.count()) % mHistory.count();
+    if (!mWorld->RestoreState(mHistory.at(index))) {
+        qWarning() << "CoreWorld: Cannot rewind, the bodies or joints have changed";
+        clearHistory();
+        return;
+    }
+
+    mHistoryHead = index;
+    mHistoryCount -= steps;
+
+    foreach (Box2DBody *body, mBodies) {
+        if (body->body()) {
+            body->resetTransforms();
+            body->synchronize();
+        }
+    }
+
+    wakeUp();
+}
+
+void Box2DCoreWorld::clearHistory()
+{
+    mHistoryCount = 0;
+}
+
+/*!
+  \qmlproperty bool CoreWorld::renderOnlyTransforms
+  Whether each step only moves the bodies on screen, instead of updating
+  their x, y and rotation properties.
+
+  Updating the properties emits their change signals and re-evaluates every
+  binding that depends on them, which adds up with thousands of bodies. In
+  this mode the bodies are moved by a transform that is applied by the
+  scene graph, and the properties are only brought up to date every
+  propertyUpdateInterval steps, or when commitTransforms() or
+  Body::commitTransform() is called. Until then, they lag behind where the
+  bodies are shown. Setting x, y or rotation still moves the body.
+
+  False by default.
+*/
+void Box2DCoreWorld::setRenderOnlyTransforms(bool renderOnlyTransforms)
+{
+    if (mRenderOnlyTransforms == renderOnlyTransforms)
+        return;
+
+    mRenderOnlyTransforms = renderOnlyTransforms;
+    foreach (Box2DBody *body, mBodies)
+        body->setRenderOnly(renderOnlyTransforms);
+
+    emit renderOnlyTransformsChanged();
+}
+
+/*!
+  \qmlproperty int CoreWorld::propertyUpdateInterval
+  Every how many steps the x, y and rotation properties of the bodies are
+  updated, with renderOnlyTransforms. 0, the default, only updates them
+  when commitTransforms() is called.
+*/
+void Box2DCoreWorld::setPropertyUpdateInterval(int propertyUpdateInterval)
+{
+    propertyUpdateInterval = qMax(0, propertyUpdateInterval);
+    if (mPropertyUpdateInterval == propertyUpdateInterval)
+        return;
+
+    mPropertyUpdateInterval = propertyUpdateInterval;
+    emit propertyUpdateIntervalChanged();
+}
+
+/*!
+  \qmlproperty ArrayBuffer CoreWorld::transforms
+  The bodies that moved in the last step, as 7 floats per body: the index
+  of the body in bodies, its x and y, rotation, linear velocity x and y,
+  and angular velocity. Reading it is a single copy, instead of a property
+  access per body. Read only.
+
+\code
+CoreWorld {
+    onStepped: {
+        var data = new Float32Array(transforms)
+        for (var i = 0; i < data.length; i += 7)
+            sprites[data[i]].move(data[i + 1], data[i + 2], data[i + 3])
+    }
+}
+\endcode
+*/
+QByteArray Box2DCoreWorld::transforms() const
+{
+    return QByteArray(reinterpret_cast<const char*>(mTransforms.constData()),
+                      mTransforms.count() * sizeof(float));
+}
+
+/*!
+  \qmlmethod Body CoreWorld::bodyAt(int index)
+  Returns the body at the given index in bodies, as used by transforms.
+*/
+Box2DBody *Box2DCoreWorld::bodyAt(int index) const
+{
+    if (index < 0 || index >= mBodies.count())
+        return 0;
+    return mBodies.at(index);
+}
+
+/**
+ * Writes the state of the bodies that moved in the last step to the
+ * transforms.
+ */
+void Box2DCoreWorld::updateTransforms()
+{
+    mTransforms.resize(mFrontBuffer.count() * TransformSize);
+    float *transform = mTransforms.data();
+
+    for (int i = 0; i < mFrontBuffer.count(); ++i) {
+        const BodyState &state = mFrontBuffer.at(i);
+        const b2Body *b = state.body->body();
+        if (!b)
+            continue;
+
+        const b2Vec2 &velocity = b->GetLinearVelocity();
+        transform[0] = state.body->mIndex;
+        transform[1] = state.current.p.x * scaleRatio;
+        transform[2] = -state.current.p.y * scaleRatio;
+        transform[3] = -(state.angle * 180.0f) / b2_pi;
+        transform[4] = velocity.x * scaleRatio;
+        transform[5] = -velocity.y * scaleRatio;
+        transform[6] = -(b->GetAngularVelocity() * 180.0f) / b2_pi;
+        transform += TransformSize;
+    }
+
+    mTransforms.resize(transform - mTransforms.data());
+}
+
+/*!
+  \qmlmethod void CoreWorld::commitTransforms()
+  Updates the x, y and rotation properties of all bodies to where they are
+  shown, with renderOnlyTransforms.
+*/
+void Box2DCoreWorld::commitTransforms()
+{
+    foreach (Box2DBody *body, mBodies)
+        body->commitTransform();
+}
+
+/**
+ * Determines whether the body is outside of the focus rectangle, and
+ * deactivates or reactivates it as needed.
+ */
+void Box2DCoreWorld::updateFocus(Box2DBody *body, const b2Vec2 &position)
+{
+    const QPointF point(position.x * scaleRatio, -position.y * scaleRatio);
+    const bool outside = !mFocusRect.isEmpty() && !mFocusRect.contains(point);
+    if (outside != body->mOutsideFocus) {
+        body->mOutsideFocus = outside;
+        mOutsideBodyCount += outside ? 1 : -1;
+    }
+
+    const bool deactivate = body->mOutsideFocus && mOutsideFocusPolicy == Deactivate
+            && !mDeterministic;
+    if (deactivate == body->mDeactivatedByFocus)
+        return;
+
+    // Leave bodies alone that were deactivated by other means
+    if (deactivate && !body->body()->IsActive())
+        return;
+
+    body->mDeactivatedByFocus = deactivate;
+    setBodyActive(body, !deactivate);
+    if (!deactivate)
+        wakeUp();
+}
+
+/**
+ * Applies a changed focus rectangle or policy right away, so that bodies
+ * are reactivated even when the world is idle. While a step is running,
+ * this is left to the end of the step.
+ */
+void Box2DCoreWorld::refocus()
+{
+    if (!mWorld || mStepPending)
+        return;
+
+    foreach (Box2DBody *body, mBodies) {
+        if (b2Body *b = body->body())
+            updateFocus(body, b->GetPosition());
+    }
+    setBodyCounts(mBodies.count() - mOutsideBodyCount, mOutsideBodyCount);
+}
+
+void Box2DCoreWorld::setBodyCounts(int fullRateBodyCount, int reducedRateBodyCount)
+{
+    if (mFullRateBodyCount == fullRateBodyCount
+            && mReducedRateBodyCount == reducedRateBodyCount)
+        return;
+
+    mFullRateBodyCount = fullRateBodyCount;
+    mReducedRateBodyCount = reducedRateBodyCount;
+    emit bodyCountsChanged();
+}
+
+bool Box2DCoreWorld::interpolationActive() const
+{
+    return mInterpolating && mExternalStepping && !mShared;
+}
+
+/**
+ * Shows the bodies that moved in the last step blended between their last
+ * two steps, where an alpha of 0 is the previous step and 1 the current one.
+ * The other bodies are already where they are.
+ */
+void Box2DCoreWorld::interpolateBodies(float32 alpha)
+{
+    for (int i = 0; i < mFrontBuffer.count(); ++i) {
+        Box2DBody *body = mFrontBuffer.at(i).body;
+        if (!body->mOutsideFocus)
+            body->interpolate(alpha);
+    }
+}
+
+/**
+ * Starts or stops the timer and the shared stepping, according to the
+ * running state.
+ */
+void Box2DCoreWorld::updateStepping()
+{
+    if (!mComponentComplete || mBuild)
+        return;
+
+    const bool stepping = mIsRunning && !mIdle && !mPaused;
+
+    if (stepping && !mShared && !mExternalStepping)
+        mTimer.start(mFrameTime, this);
+    else
+        mTimer.stop();
+
+    if (stepping && mShared)
+        Box2DScheduler::instance()->registerWorld(this);
+    else
+        Box2DScheduler::instance()->unregisterWorld(this);
+
+    // While idle, only check now and then for bodies woken up by joints
+    if (mIsRunning && mIdle && !mPaused)
+        mIdleTimer.start(250, this);
+    else
+        mIdleTimer.stop();
+}
+
+void Box2DCoreWorld::classBegin()
+{
+}
+
+void Box2DCoreWorld::componentComplete()
+{
+    mComponentComplete = true;
+
+    if (mAsynchronous) {
+        startBuild();
+        return;
+    }
+
+    setupWorld(new b2World(b2Vec2(mGravity.x(), -mGravity.y())));
+
+    foreach (Box2DBody *body, mBodies)
+        body->initialize(this);
+
+    emit initialized();
+    emit ready();
+    updateStepping();
+}
+
+void Box2DCoreWorld::setupWorld(b2World *world)
+{
+    mWorld = world;
+    mWorld->SetGravity(b2Vec2(mGravity.x(), -mGravity.y()));
+    mWorld->SetDeterministic(mDeterministic);
+    mWorld->SetContactListener(mContactListener);
+    mWorld->SetDestructionListener(mDestructionListener);
+}
+
+/*!
+  \qmlproperty bool CoreWorld::asynchronous
+  Whether the world is built on a worker thread, so that loading a large
+  level does not block the GUI thread and a splash screen keeps animating.
+
+  When the component is complete, the definitions of the bodies declared in
+  the world and of their fixtures are collected on the GUI thread. The
+  b2World is then populated on the worker thread, including the costly
+  convex hull computation of polygons, and swapped in once it is done, at
+  which point loading becomes false and ready() is emitted. Joints and
+  light bodies are created after that, on the GUI thread. Until then the
+  world does not step, and bodies have no b2Body. Bodies added, moved or
+  changed in the meantime are taken into account.
+
+  Only read when the component is complete. False by default.
+*/
+void Box2DCoreWorld::setAsynchronous(bool asynchronous)
+{
+    if (mAsynchronous == asynchronous)
+        return;
+
+    mAsynchronous = asynchronous;
+    emit asynchronousChanged();
+}
+
+/*!
+  \qmlproperty bool CoreWorld::loading
+  Whether an asynchronous world is still being built. Read only.
+*/
+
+/*!
+  \qmlsignal CoreWorld::ready()
+  Emitted once the bodies declared in the world have been created. For an
+  asynchronous world this is when it is swapped in, otherwise right when
+  the component is complete.
+*/
+
+/**
+ * Collects the definitions of the bodies and their fixtures, and starts
+ * building the b2World from them on the worker thread.
+ */
+void Box2DCoreWorld::startBuild()
+{
+    mBuild = new WorldBuild;
+    mBuild->gravity.Set(mGravity.x(), -mGravity.y());
+    mBuild->bodies.reserve(mBodies.count());
+
+    foreach (Box2DBody *body, mBodies) {
+        // Initialized once it is complete, after the world was swapped in
+        if (!body->isComponentComplete())
+            continue;
+
+        WorldBuild::Body record;
+        record.body = body;
+        record.bodyDef = body->mBodyDef;
+        record.bodyDef.position.Set(body->x() / scaleRatio, -body->y() / scaleRatio);
+        record.bodyDef.angle = -(body->rotation() * (2 * b2_pi)) / 360.0;
+        record.bodyDef.gravityScale = body->mGravityScale;
+        record.b2body = 0;
+
+        foreach (Box2DFixture *fixture, body->mFixtures) {
+            WorldBuild::Fixture f;
+            f.fixture = fixture;
+            f.fixtureDef = fixture->mFixtureDef;
+            f.shape = fixture->createDeferredShape(&f.hull);
+            f.b2fixture = 0;
+            fixture->mDirty = false;
+            if (f.shape)
+                record.fixtures.append(f);
+        }
+        foreach (Box2DLightFixture *fixture, body->mLightFixtures) {
+            WorldBuild::Fixture f;
+            f.lightFixture = fixture;
+            f.fixtureDef = fixture->mFixtureDef;
+            f.shape = fixture->createDeferredShape(&f.hull);
+            f.b2fixture = 0;
+            fixture->mDirty = false;
+            if (f.shape)
+                record.fixtures.append(f);
+        }
+
+        mBuild->bodies.append(record);
+    }
+
+    if (!mBuildPool) {
+        mBuildPool = new QThreadPool(this);
+        mBuildPool->setMaxThreadCount(1);
+    }
+    mBuildPool->start(new BuildJob(this));
+
+    emit loadingChanged();
+}
+
+/**
+ * Swaps in the b2World built on the worker thread and hands the bodies
+ * their b2Bodies and b2Fixtures. Bodies added in the meantime are then
+ * initialized as usual.
+ */
+void Box2DCoreWorld::finishBuild()
+{
+    WorldBuild *build = mBuild;
+    mBuild = 0;
+    setupWorld(build->world);
+    build->world = 0;
+
+    foreach (const WorldBuild::Body &record, build->bodies) {
+        Box2DBody *body = record.body;
+
+        // Deleted or removed from the world in the meantime
+        if (!body || !mBodies.contains(body) || body->mBody) {
+            mWorld->DestroyBody(record.b2body);
+            continue;
+        }
+
+        // Fixtures removed or changed in the meantime are destroyed, and the
+        // changed ones recreated along with the added ones
+        foreach (const WorldBuild::Fixture &f, record.fixtures) {
+            if (f.fixture && !f.fixture->mDirty
+                    && body->mFixtures.contains(f.fixture)) {
+                f.fixture->mFixture = f.b2fixture;
+                f.fixture->mBody = record.b2body;
+                f.b2fixture->SetUserData(f.fixture);
+            } else if (f.lightFixture && !f.lightFixture->mDirty
+                       && body->mLightFixtures.contains(f.lightFixture)) {
+                f.lightFixture->mFixture = f.b2fixture;
+            } else {
+                record.b2body->DestroyFixture(f.b2fixture);
+            }
+        }
+
+        foreach (Box2DFixture *fixture, body->mFixtures) {
+            if (!fixture->mFixture)
+                fixture->createFixture(record.b2body);
+        }
+        foreach (Box2DLightFixture *fixture, body->mLightFixtures) {
+            if (!fixture->mFixture)
+                fixture->createFixture(record.b2body);
+        }
+
+        // Changed in the meantime
+        updateBodyFromDef(record.b2body, body->mBodyDef, body->mGravityScale);
+        body->adoptBody(this, record.b2body);
+    }
+    delete build;
+
+    foreach (Box2DBody *body, mBodies) {
+        if (!body->mBody)
+            body->initialize(this);
+    }
+
+    emit loadingChanged();
+    emit initialized();
+    emit ready();
+    updateStepping();
+}
+
+/**
+ * Registers a Box2D body with this world. When the world component is
+ * complete, it will initialize the body.
+ */
+void Box2DCoreWorld::registerBody(Box2DBody *body)
+{
+    if (mBodies.contains(body))
+        return;
+
+    body->mIndex = mBodies.count();
+    mBodies.append(body);
+    connect(body, SIGNAL(destroyed()), this, SLOT(unregisterBody()));
+    body->setRenderOnly(mRenderOnlyTransforms);
+    if (body->observedProperties())
+        mObservedBodies.append(body);
+
+    if (mWorld) {
+        body->initialize(this);
+        wakeUp();
+    }
+}
+
+/*!
+  \qmlproperty list<Body> CoreWorld::bodies
+  The bodies simulated by the world. This is the default property, so
+  bodies can be declared directly inside of a CoreWorld.
+*/
+QQmlListProperty<Box2DBody> Box2DCoreWorld::bodies()
+{
+    return QQmlListProperty<Box2DBody>(this, 0,
+                                       &Box2DCoreWorld::append_body,
+                                       &Box2DCoreWorld::count_body,
+                                       &Box2DCoreWorld::at_body,
+                                       0);
+}
+
+void Box2DCoreWorld::append_body(QQmlListProperty<Box2DBody> *list,
+                                 Box2DBody *body)
+{
+    Box2DCoreWorld *world = static_cast<Box2DCoreWorld*>(list->object);
+    if (!body->parent())
+        body->setParent(world);
+    world->registerBody(body);
+}
+
+int Box2DCoreWorld::count_body(QQmlListProperty<Box2DBody> *list)
+{
+    Box2DCoreWorld *world = static_cast<Box2DCoreWorld*>(list->object);
+    return world->mBodies.count();
+}
+
+Box2DBody *Box2DCoreWorld::at_body(QQmlListProperty<Box2DBody> *list, int index)
+{
+    Box2DCoreWorld *world = static_cast<Box2DCoreWorld*>(list->object);
+    if (index < 0 || index >= world->mBodies.count()) return NULL;
+    return world->mBodies.at(index);
+}
+
+/**
+ * Unregisters a Box2D body from this world. Called when a dynamically
+ * created Box2D body has been deleted.
+ */
+void Box2DCoreWorld::unregisterBody()
+{
+    forgetBody(static_cast<Box2DBody*>(sender()));
+}
+
+/**
+ * Removes a body from this world without deleting it, destroying its
+ * b2Body. Used to move a body to another world.
+ */
+void Box2DCoreWorld::releaseBody(Box2DBody *body)
+{
+    if (!mBodies.contains(body))
+        return;
+
+    disconnect(body, SIGNAL(destroyed()), this, SLOT(unregisterBody()));
+    forgetBody(body);
+    body->cleanup(mWorld);
+}
+
+/**
+ * Starts or stops comparing the observed properties of the body after each
+ * step, depending on whether it observes any.
+ */
+void Box2DCoreWorld::observeBody(Box2DBody *body)
+{
+    if (!mBodies.contains(body))
+        return;
+
+    const bool observed = body->observedProperties() != 0;
+    if (observed && !mObservedBodies.contains(body))
+        mObservedBodies.append(body);
+    else if (!observed)
+        mObservedBodies.removeOne(body);
+}
+
+/**
+ * Drops all references to a body that left this world.
+ */
+void Box2DCoreWorld::forgetBody(Box2DBody *body)
+{
+    // The body may be in the middle of being deleted, so only the indices of
+    // the bodies after it are updated
+    const int index = mBodies.indexOf(body);
+    if (index != -1) {
+        mBodies.removeAt(index);
+        for (int i = index; i < mBodies.count(); ++i)
+            mBodies.at(i)->mIndex = i;
+    }
+    mObservedBodies.removeOne(body);
+
+    // Drop any transform still buffered for the body
+    for (int i = mBackBuffer.count() - 1; i >= 0; --i) {
+        if (mBackBuffer.at(i).body == body)
+            mBackBuffer.remove(i);
+    }
+    for (int i = mFrontBuffer.count() - 1; i >= 0; --i) {
+        if (mFrontBuffer.at(i).body == body)
+            mFrontBuffer.remove(i);
+    }
+
+    // As well as any change still waiting for the step to finish
+    for (int i = mCommands.count() - 1; i >= 0; --i) {
+        const Command &command = mCommands.at(i);
+        if (command.body == body) {
+            delete command.shape;
+            mCommands.removeAt(i);
+        }
+    }
+}
+
+/**
+ * Blocks until the step running on the physics thread, if any, is done.
+ */
+void Box2DCoreWorld::waitForStep() const
+{
+    if (mStepPending && mStepPool)
+        mStepPool->waitForDone();
+}
+
+b2World *Box2DCoreWorld::cloneWorld()
+{
+    if (!mWorld)
+        return 0;
+
+    waitForStep();
+    return mWorld->Clone();
+}
+
+/*!
+  \qmlmethod list<point> CoreWorld::predictTrajectory(Body body, point impulse, int steps)
+  Predicts where the body goes over the given number of steps after the
+  impulse is applied to its center, and returns its position before and
+  after each step, in pixels.
+
+  Only the body is simulated, with gravity and its damping. The rest of the
+  world is frozen as it is: the body bounces off other bodies as if they were
+  static, and joints are ignored. This is cheap enough to be called on every
+  frame, for example to draw an aim guide.
+
+\code
+Canvas {
+    onPaint: {
+        var points = world.predictTrajectory(ball, aimImpulse, 60)
+        var ctx = getContext("2d")
+        ctx.reset()
+        ctx.moveTo(points[0].x, points[0].y)
+        for (var i = 1; i < points.length; ++i)
+            ctx.lineTo(points[i].x, points[i].y)
+        ctx.stroke()
+    }
+}
+\endcode
+*/
+QVariantList Box2DCoreWorld::predictTrajectory(Box2DBody *body,
+                                               const QPointF &impulse,
+                                               int steps)
+{
+    QVariantList points;
+
+    b2Body *source = body ? body->body() : 0;
+    if (!source || source->GetWorld() != mWorld || steps < 1)
+        return points;
+
+    // The physics thread may still be moving the bodies
+    waitForStep();
+
+    // A small world with a copy of the body, to which the bodies it may run
+    // into are added as static copies as it goes
+    b2World world(mWorld->GetGravity());
+    world.SetAllowSleeping(false);
+
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.position = source->GetPosition();
+    bodyDef.angle = source->GetAngle();
+    bodyDef.linearVelocity = source->GetLinearVelocity();
+    bodyDef.angularVelocity = source->GetAngularVelocity();
+    bodyDef.linearDamping = source->GetLinearDamping();
+    bodyDef.angularDamping = source->GetAngularDamping();
+    bodyDef.gravityScale = source->GetGravityScale();
+    bodyDef.fixedRotation = source->IsFixedRotation();
+    bodyDef.bullet = source->IsBullet();
+    b2Body *projectile = world.CreateBody(&bodyDef);
+
+    for (b2Fixture *f = source->GetFixtureList(); f; f = f->GetNext()) {
+        if (f->IsSensor())
+            continue;
+
+        b2FixtureDef fixtureDef;
+        fixtureDef.shape = f->GetShape();
+        fixtureDef.friction = f->GetFriction();
+        fixtureDef.restitution = f->GetRestitution();
+        fixtureDef.density = f->GetDensity();
+        fixtureDef.filter = f->GetFilterData();
+        projectile->CreateFixture(&fixtureDef);
+    }
+
+    b2MassData massData;
+    source->GetMassData(&massData);
+    projectile->SetMassData(&massData);
+
+    projectile->ApplyLinearImpulse(b2Vec2(impulse.x() / scaleRatio,
+                                          -impulse.y() / scaleRatio),
+                                   projectile->GetWorldCenter(), true);
+
+    QHash<b2Body*, b2Body*> obstacles;
+    QSet<b2Fixture*> copied;
+    FixtureCollector collector;
+
+    b2Vec2 position = projectile->GetPosition();
+    points.append(QPointF(position.x * scaleRatio, -position.y * scaleRatio));
+
+    for (int i = 0; i < steps; ++i) {
+        // The area the body can reach during this step
+        const b2Transform &transform = projectile->GetTransform();
+        const b2Vec2 displacement = mTimeStep * projectile->GetLinearVelocity();
+        b2AABB reach;
+        reach.lowerBound = reach.upperBound = transform.p;
+        for (b2Fixture *f = projectile->GetFixtureList(); f; f = f->GetNext()) {
+            for (int32 child = 0; child < f->GetShape()->GetChildCount(); ++child) {
+                b2AABB aabb;
+                f->GetShape()->ComputeAABB(&aabb, transform, child);
+                reach.Combine(aabb);
+            }
+        }
+        reach.lowerBound += b2Min(displacement, b2Vec2_zero) - b2Vec2(b2_aabbExtension, b2_aabbExtension);
+        reach.upperBound += b2Max(displacement, b2Vec2_zero) + b2Vec2(b2_aabbExtension, b2_aabbExtension);
+
+        collector.fixtures.clear();
+        mWorld->QueryAABB(&collector, reach);
+
+        foreach (b2Fixture *f, collector.fixtures) {
+            if (f->GetBody() == source || f->IsSensor() || copied.contains(f))
+                continue;
+            copied.insert(f);
+
+            b2Body *&obstacle = obstacles[f->GetBody()];
+            if (!obstacle) {
+                b2BodyDef obstacleDef;
+                obstacleDef.position = f->GetBody()->GetPosition();
+                obstacleDef.angle = f->GetBody()->GetAngle();
+                obstacle = world.CreateBody(&obstacleDef);
+            }
+
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = f->GetShape();
+            fixtureDef.friction = f->GetFriction();
+            fixtureDef.restitution = f->GetRestitution();
+            fixtureDef.filter = f->GetFilterData();
+            obstacle->CreateFixture(&fixtureDef);
+        }
+
+        world.Step(mTimeStep, mVelocityIterations, mPositionIterations);
+
+        position = projectile->GetPosition();
+        points.append(QPointF(position.x * scaleRatio, -position.y * scaleRatio));
+    }
+
+    return points;
+}
+
+bool Box2DCoreWorld::isLocked() const
+{
+    return mStepPending || mDispatching || (mWorld && mWorld->IsLocked());
+}
+
+/**
+ * Creates the b2Body of a body, once no step is running.
+ */
+void Box2DCoreWorld::createBody(Box2DBody *body)
+{
+    Command command(Command::CreateBody);
+    command.body = body;
+    submit(command);
+}
+
+/**
+ * Destroys a b2Body, once no step is running. When the destruction has to
+ * wait, the b2Body and its fixtures are detached from their wrappers right
+ * away, since those are about to be deleted.
+ */
+void Box2DCoreWorld::destroyBody(b2Body *body)
+{
+    // The physics thread may still be reading the user data of the body
+    waitForStep();
+
+    Box2DBody *wrapper = static_cast<Box2DBody*>(body->GetUserData());
+    if (wrapper && wrapper->mOutsideFocus) {
+        wrapper->mOutsideFocus = false;
+        --mOutsideBodyCount;
+    }
+
+    if (isLocked())
+        detachBody(body);
+
+    Command command(Command::DestroyBody);
+    command.b2body = body;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyTransform(Box2DBody *body, const b2Vec2 &position,
+                                  float32 angle)
+{
+    Command command(Command::SetTransform);
+    command.body = body;
+    command.vector = position;
+    command.value = angle;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyLinearVelocity(Box2DBody *body, const b2Vec2 &velocity)
+{
+    Command command(Command::SetLinearVelocity);
+    command.body = body;
+    command.vector = velocity;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyAngularVelocity(Box2DBody *body, float32 velocity)
+{
+    Command command(Command::SetAngularVelocity);
+    command.body = body;
+    command.value = velocity;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyAwake(Box2DBody *body, bool awake)
+{
+    Command command(Command::SetAwake);
+    command.body = body;
+    command.flag = awake;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyActive(Box2DBody *body, bool active)
+{
+    Command command(Command::SetActive);
+    command.body = body;
+    command.flag = active;
+    submit(command);
+}
+
+/**
+ * Brings the type, damping, gravity scale and flags of the b2Body in line
+ * with the definition of the body, once no step is running.
+ */
+void Box2DCoreWorld::updateBody(Box2DBody *body)
+{
+    Command command(Command::UpdateBody);
+    command.body = body;
+    submit(command);
+}
+
+void Box2DCoreWorld::updateBody(Box2DLightBody *body)
+{
+    Command command(Command::UpdateBody);
+    command.lightBody = body;
+    submit(command);
+}
+
+void Box2DCoreWorld::applyForce(Box2DBody *body, const b2Vec2 &force,
+                            const b2Vec2 &point)
+{
+    Command command(Command::ApplyForce);
+    command.body = body;
+    command.vector = force;
+    command.point = point;
+    submit(command);
+}
+
+/**
+ * Applies a force to the center of mass of a body, which is only known once
+ * no step is running.
+ */
+void Box2DCoreWorld::applyForceToCenter(Box2DBody *body, const b2Vec2 &force)
+{
+    Command command(Command::ApplyForceToCenter);
+    command.body = body;
+    command.vector = force;
+    submit(command);
+}
+
+void Box2DCoreWorld::applyLinearImpulse(Box2DBody *body, const b2Vec2 &impulse,
+                                    const b2Vec2 &point)
+{
+    Command command(Command::ApplyLinearImpulse);
+    command.body = body;
+    command.vector = impulse;
+    command.point = point;
+    submit(command);
+}
+
+void Box2DCoreWorld::applyTorque(Box2DBody *body, float32 torque)
+{
+    Command command(Command::ApplyTorque);
+    command.body = body;
+    command.value = torque;
+    submit(command);
+}
+
+/**
+ * Replaces the shape of a fixture, once no step is running. Takes ownership
+ * of the shape.
+ */
+void Box2DCoreWorld::reshapeFixture(Box2DFixture *fixture, b2Shape *shape)
+{
+    if (!shape)
+        return;
+
+    Command command(Command::ReshapeFixture);
+    command.body = fixture->GetBody();
+    command.fixture = fixture;
+    command.shape = shape;
+    submit(command);
+}
+
+/**
+ * Brings the density, friction, restitution and sensor flag of the
+ * b2Fixture in line with the definition of the fixture, once no step is
+ * running.
+ */
+void Box2DCoreWorld::updateFixture(Box2DFixture *fixture)
+{
+    Command command(Command::UpdateFixture);
+    command.body = fixture->GetBody();
+    command.fixture = fixture;
+    submit(command);
+}
+
+void Box2DCoreWorld::updateFixture(Box2DLightFixture *fixture)
+{
+    Command command(Command::UpdateFixture);
+    // So that the command is dropped along with the body
+    command.body = qobject_cast<Box2DBody*>(fixture->parent());
+    command.lightBody = qobject_cast<Box2DLightBody*>(fixture->parent());
+    command.lightFixture = fixture;
+    submit(command);
+}
+
+/**
+ * Creates the b2Joint of a joint, once no step is running.
+ */
+void Box2DCoreWorld::createJoint(Box2DJoint *joint)
+{
+    Command command(Command::CreateJoint);
+    command.joint = joint;
+    submit(command);
+}
+
+/**
+ * Destroys a b2Joint, once no step is running. The caller is expected to
+ * have cleared its user data.
+ */
+void Box2DCoreWorld::destroyJoint(b2Joint *joint)
+{
+    waitForStep();
+
+    Command command(Command::DestroyJoint);
+    command.b2joint = joint;
+    submit(command);
+}
+
+/**
+ * Brings the parameters of the b2Joint, such as its limits and motor, in
+ * line with the definition of the joint, once no step is running.
+ */
+void Box2DCoreWorld::updateJoint(Box2DJoint *joint)
+{
+    Command command(Command::UpdateJoint);
+    command.joint = joint;
+    submit(command);
+}
+
+/**
+ * Drops the changes still waiting for a joint that is being deleted.
+ */
+void Box2DCoreWorld::cancelCommands(Box2DJoint *joint)
+{
+    for (int i = mCommands.count() - 1; i >= 0; --i) {
+        if (mCommands.at(i).joint == joint)
+            mCommands.removeAt(i);
+    }
+}
+
+Box2DCoreWorld::BodyTemplate::~BodyTemplate()
+{
+    foreach (const b2FixtureDef &fixtureDef, fixtureDefs)
+        delete fixtureDef.shape;
+}
+
+/*!
+  \qmlmethod int CoreWorld::createBodies(LightBody prototype, positions)
+  Creates a body for each position, all with the type, damping and
+  fixtures of the prototype, a LightBody that is not in a world, so not
+  declared inside of a World either. The
+  positions are x and y pairs in pixels, given as an ArrayBuffer of 32-bit
+  floats, for example the buffer of a Float32Array, or as a list of numbers.
+
+  This is much faster than creating the bodies one by one: the shapes are
+  built once for all bodies and no objects are created for them. The bodies
+  are not synchronized with anything after each step and do not emit
+  contact signals, which makes them suited for loading the static geometry
+  of a level.
+
+  Returns the handle of the first body, or -1 when no body was created. The
+  bodies have consecutive handles, which can be passed to destroyBodies()
+  and handlePosition().
+*/
+int Box2DCoreWorld::createBodies(Box2DLightBody *prototype,
+                                 const QVariant &positions)
+{
+    QVector<float> values;
+    if (positions.type() == QVariant::ByteArray) {
+        const QByteArray data = positions.toByteArray();
+        values.resize(data.size() / sizeof(float));
+        memcpy(values.data(), data.constData(), values.size() * sizeof(float));
+    } else {
+        const QVariantList list = positions.toList();
+        values.reserve(list.count());
+        foreach (const QVariant &value, list)
+            values.append(value.toFloat());
+    }
+
+    return createBodies(prototype, values.constData(), values.count() / 2);
+}
+
+/**
+ * Creates count bodies from the prototype at the given positions, x and y
+ * pairs in pixels. Returns the handle of the first body, or -1.
+ */
+int Box2DCoreWorld::createBodies(Box2DLightBody *prototype,
+                                 const float *positions, int count)
+{
+    if (!prototype || count < 1 || !mWorld)
+        return -1;
+
+    BodyTemplate *bodyTemplate = new BodyTemplate;
+    bodyTemplate->bodyDef = prototype->mBodyDef;
+    bodyTemplate->bodyDef.gravityScale = prototype->mGravityScale;
+
+    foreach (Box2DLightFixture *fixture, prototype->mLightFixtures) {
+        b2FixtureDef fixtureDef = fixture->mFixtureDef;
+        fixtureDef.shape = fixture->createShape();
+        if (fixtureDef.shape)
+            bodyTemplate->fixtureDefs.append(fixtureDef);
+    }
+
+    bodyTemplate->positions.resize(count * 2);
+    for (int i = 0; i < count * 2; ++i)
+        bodyTemplate->positions[i] = positions[i] / scaleRatio;
+
+    // The handles are taken right away, the bodies may have to wait
+    Command command(Command::CreateBodies);
+    command.bodyTemplate = bodyTemplate;
+    command.handle = takeHandles(count);
+    command.count = count;
+    submit(command);
+
+    return command.handle;
+}
+
+/*!
+  \qmlmethod CoreWorld::destroyBodies(int handle, int count)
+  Destroys count bodies created by createBodies(), starting at the given
+  handle. The handles are given to bodies created later. A range that
+  includes bodies that were already destroyed is ignored.
+*/
+void Box2DCoreWorld::destroyBodies(int handle, int count)
+{
+    if (handle < 0 || count < 1 || handle + count > mHandles.count())
+        return;
+
+    foreach (const HandleRange &range, mFreeHandles) {
+        if (range.first < handle + count && handle < range.first + range.count) {
+            qWarning() << "CoreWorld: Cannot destroy bodies" << handle << "to"
+                       << handle + count - 1 << "since some were already destroyed";
+            return;
+        }
+    }
+
+    Command command(Command::DestroyBodies);
+    command.handle = handle;
+    command.count = count;
+    submit(command);
+
+    // Commands are applied in order, so the handles can be given out again
+    // before the bodies are gone
+    releaseHandles(handle, count);
+}
+
+/**
+ * Finds count consecutive free handles, reusing released ones first, and
+ * grows the handles when there are none.
+ */
+int Box2DCoreWorld::takeHandles(int count)
+{
+    for (int i = 0; i < mFreeHandles.count(); ++i) {
+        HandleRange &range = mFreeHandles[i];
+        if (range.count < count)
+            continue;
+
+        const int first = range.first;
+        range.first += count;
+        range.count -= count;
+        if (range.count == 0)
+            mFreeHandles.remove(i);
+        return first;
+    }
+
+    // A free range at the end only needs to grow by what it lacks
+    int first = mHandles.count();
+    if (!mFreeHandles.isEmpty()) {
+        const HandleRange &last = mFreeHandles.last();
+        if (last.first + last.count == mHandles.count()) {
+            first = last.first;
+            mFreeHandles.remove(mFreeHandles.count() - 1);
+        }
+    }
+    mHandles.resize(first + count);
+    return first;
+}
+
+/**
+ * Marks handles as free. The ranges are kept sorted and merged, so handles
+ * that are released twice are only given out once.
+ */
+void Box2DCoreWorld::releaseHandles(int first, int count)
+{
+    int last = first + count;
+
+    // Absorb the ranges that overlap or touch the released one
+    int i = 0;
+    while (i < mFreeHandles.count()
+           && mFreeHandles.at(i).first + mFreeHandles.at(i).count < first)
+        ++i;
+    while (i < mFreeHandles.count() && mFreeHandles.at(i).first <= last) {
+        const HandleRange &range = mFreeHandles.at(i);
+        first = qMin(first, range.first);
+        last = qMax(last, range.first + range.count);
+        mFreeHandles.remove(i);
+    }
+
+    HandleRange range;
+    range.first = first;
+    range.count = last - first;
+    mFreeHandles.insert(i, range);
+}
+
+/*!
+  \qmlmethod point CoreWorld::handlePosition(int handle)
+  The position in pixels of a body created by createBodies().
+*/
+QPointF Box2DCoreWorld::handlePosition(int handle) const
+{
+    const b2Body *b = handleBody(handle);
+    if (!b)
+        return QPointF();
+
+    waitForStep();
+
+    const b2Vec2 &position = b->GetPosition();
+    return QPointF(position.x * scaleRatio, -position.y * scaleRatio);
+}
+
+/**
+ * Moves a body created by createBodies(), once no step is running.
+ */
+void Box2DCoreWorld::setHandleTransform(int handle, const b2Vec2 &position,
+                                        float32 angle)
+{
+    Command command(Command::SetTransform);
+    command.handle = handle;
+    command.vector = position;
+    command.value = angle;
+    submit(command);
+}
+
+/**
+ * Creates the b2Body of a light body, once no step is running.
+ */
+void Box2DCoreWorld::createBody(Box2DLightBody *body)
+{
+    Command command(Command::CreateBody);
+    command.lightBody = body;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyTransform(Box2DLightBody *body,
+                                      const b2Vec2 &position, float32 angle)
+{
+    Command command(Command::SetTransform);
+    command.lightBody = body;
+    command.vector = position;
+    command.value = angle;
+    submit(command);
+}
+
+void Box2DCoreWorld::setBodyLinearVelocity(Box2DLightBody *body,
+                                           const b2Vec2 &velocity)
+{
+    Command command(Command::SetLinearVelocity);
+    command.lightBody = body;
+    command.vector = velocity;
+    submit(command);
+}
+
+void Box2DCoreWorld::applyForce(Box2DLightBody *body, const b2Vec2 &force,
+                                const b2Vec2 &point)
+{
+    Command command(Command::ApplyForce);
+    command.lightBody = body;
+    command.vector = force;
+    command.point = point;
+    submit(command);
+}
+
+void Box2DCoreWorld::applyLinearImpulse(Box2DLightBody *body,
+                                        const b2Vec2 &impulse,
+                                        const b2Vec2 &point)
+{
+    Command command(Command::ApplyLinearImpulse);
+    command.lightBody = body;
+    command.vector = impulse;
+    command.point = point;
+    submit(command);
+}
+
+/**
+ * Drops the changes still waiting for a light body, or for one of its
+ * fixtures, when the body leaves the world.
+ */
+void Box2DCoreWorld::cancelCommands(Box2DLightBody *body)
+{
+    for (int i = mCommands.count() - 1; i >= 0; --i) {
+        const Command &command = mCommands.at(i);
+        if (command.lightBody == body) {
+            delete command.shape;
+            mCommands.removeAt(i);
+        }
+    }
+}
+
+/**
+ * Applies the change right away when possible, and otherwise queues it until
+ * the running step is finished. A queued transform or shape replaces the one
+ * already waiting for the same body or fixture.
+ */
+void Box2DCoreWorld::submit(const Command &command)
+{
+    if (!isLocked()) {
+        apply(command);
+        return;
+    }
+
+    if (command.type == Command::SetTransform
+            || command.type == Command::ReshapeFixture
+            || command.type == Command::UpdateBody
+            || command.type == Command::UpdateFixture
+            || command.type == Command::UpdateJoint) {
+        for (int i = 0; i < mCommands.count(); ++i) {
+            Command &queued = mCommands[i];
+            if (queued.type == command.type && queued.body == command.body
+                    && queued.lightBody == command.lightBody
+                    && queued.handle == command.handle
+                    && queued.fixture == command.fixture
+                    && queued.lightFixture == command.lightFixture
+                    && queued.joint == command.joint) {
+                delete queued.shape;
+                queued = command;
+                return;
+            }
+        }
+    }
+
+    mCommands.append(command);
+}
+
+void Box2DCoreWorld::apply(const Command &command)
+{
+    b2Body *b = 0;
+    if (command.body)
+        b = command.body->body();
+    else if (command.lightBody)
+        b = command.lightBody->body();
+    else if (command.type == Command::SetTransform)
+        b = handleBody(command.handle);
+
+    switch (command.type) {
+    case Command::CreateBody:
+        if (command.lightBody) {
+            if (command.lightBody->coreWorld() == this && !b) {
+                command.lightBody->createBody();
+                clearHistory();
+            }
+        } else if (command.body->coreWorld() == this && !b) {
+            command.body->createBody();
+            clearHistory();
+        }
+        break;
+    case Command::DestroyBody:
+        // Its joints are destroyed along with the body
+        for (b2JointEdge *edge = command.b2body->GetJointList(); edge; edge = edge->next) {
+            for (int i = mCommands.count() - 1; i >= 0; --i) {
+                if (mCommands.at(i).b2joint == edge->joint)
+                    mCommands.removeAt(i);
+            }
+        }
+        mWorld->DestroyBody(command.b2body);
+        clearHistory();
+        break;
+    case Command::SetTransform:
+        if (b) {
+            b->SetTransform(command.vector, command.value);
+            if (command.body)
+                command.body->resetTransforms();
+            else if (command.lightBody)
+                command.lightBody->mTransformPending = false;
+        }
+        break;
+    case Command::SetLinearVelocity:
+        if (b)
+            b->SetLinearVelocity(command.vector);
+        break;
+    case Command::SetAngularVelocity:
+        if (b)
+            b->SetAngularVelocity(command.value);
+        break;
+    case Command::SetAwake:
+        if (b && b->IsAwake() != command.flag)
+            b->SetAwake(command.flag);
+        if (command.body)
+            command.body->mAwakePending = false;
+        break;
+    case Command::SetActive:
+        if (b && b->IsActive() != command.flag) {
+            b->SetActive(command.flag);
+            clearHistory();
+        }
+        break;
+    case Command::ApplyForce:
+        if (b)
+            b->ApplyForce(command.vector, command.point, true);
+        break;
+    case Command::ApplyForceToCenter:
+        if (b)
+            b->ApplyForceToCenter(command.vector, true);
+        break;
+    case Command::ApplyLinearImpulse:
+        if (b)
+            b->ApplyLinearImpulse(command.vector, command.point, true);
+        break;
+    case Command::ApplyTorque:
+        if (b)
+            b->ApplyTorque(command.value, true);
+        break;
+    case Command::ReshapeFixture:
+        command.fixture->replaceShape(command.shape);
+        clearHistory();
+        break;
+    case Command::UpdateBody:
+        if (!b)
+            break;
+        if (command.lightBody ? updateBodyFromDef(b, command.lightBody->mBodyDef,
+                                                  command.lightBody->mGravityScale)
+                              : updateBodyFromDef(b, command.body->mBodyDef,
+                                                  command.body->mGravityScale))
+            clearHistory();
+        break;
+    case Command::UpdateFixture:
+        if (command.lightFixture) {
+            if (command.lightFixture->mFixture)
+                updateFixtureFromDef(command.lightFixture->mFixture,
+                                     command.lightFixture->mFixtureDef);
+        } else if (command.fixture->mFixture) {
+            updateFixtureFromDef(command.fixture->mFixture,
+                                 command.fixture->mFixtureDef);
+        }
+        break;
+    case Command::UpdateJoint:
+        if (command.joint->GetJoint())
+            command.joint->updateJointFromDef();
+        break;
+    case Command::CreateJoint:
+        command.joint->createJoint();
+        clearHistory();
+        break;
+    case Command::DestroyJoint:
+        mWorld->DestroyJoint(command.b2joint);
+        clearHistory();
+        break;
+    case Command::SetGravity:
+        mWorld->SetGravity(command.vector);
+
+        // Sleeping bodies would not notice the new gravity
+        for (b2Body *body = mWorld->GetBodyList(); body; body = body->GetNext())
+            body->SetAwake(true);
+        break;
+    case Command::Rewind:
+        restoreState(command.steps);
+        break;
+    case Command::CreateBodies: {
+        const BodyTemplate *bodyTemplate = command.bodyTemplate;
+        b2BodyDef bodyDef = bodyTemplate->bodyDef;
+        for (int i = 0; i < command.count; ++i) {
+            bodyDef.position.Set(bodyTemplate->positions.at(i * 2),
+                                 -bodyTemplate->positions.at(i * 2 + 1));
+            b2Body *body = mWorld->CreateBody(&bodyDef);
+            foreach (const b2FixtureDef &fixtureDef, bodyTemplate->fixtureDefs)
+                body->CreateFixture(&fixtureDef);
+            mHandles[command.handle + i] = body;
+        }
+        delete bodyTemplate;
+        clearHistory();
+        break;
+    }
+    case Command::DestroyBodies:
+        for (int i = command.handle; i < command.handle + command.count; ++i) {
+            if (mHandles.at(i)) {
+                mWorld->DestroyBody(mHandles.at(i));
+                mHandles[i] = 0;
+            }
+        }
+        clearHistory();
+        break;
+    }
+}
+
+/**
+ * Applies the changes that were queued during the last step, in the order
+ * they were made.
+ */
+void Box2DCoreWorld::flushCommands()
+{
+    while (!mCommands.isEmpty())
+        apply(mCommands.takeFirst());
+}
+
+void Box2DCoreWorld::discardCommands()
+{
+    foreach (const Command &command, mCommands) {
+        delete command.shape;
+        delete command.bodyTemplate;
+    }
+    mCommands.clear();
+}
+
+/**
+ * Separates a b2Body whose destruction is deferred from its wrappers, so
+ * that neither the next step nor the pending contact signals refer to them.
+ */
+void Box2DCoreWorld::detachBody(b2Body *body)
+{
+    for (b2Fixture *f = body->GetFixtureList(); f; f = f->GetNext()) {
+        fixtureDestroyed(toBox2DFixture(f));
+        f->SetUserData(0);
+    }
+    body->SetUserData(0);
+}
+
+void Box2DCoreWorld::fixtureDestroyed(Box2DFixture *fixture)
+{
+    if (fixture)
+        mContactListener->removeFixture(fixture);
+}
+
+void Box2DCoreWorld::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == mTimer.timerId()) {
+        advance(1);
+    } else if (event->timerId() == mIdleTimer.timerId()) {
+        for (b2Body *b = mWorld->GetBodyList(); b; b = b->GetNext()) {
+            if (b->IsAwake() && b->IsActive() && b->GetType() != b2_staticBody) {
+                wakeUp();
+                break;
+            }
+        }
+    }
+
+    QObject::timerEvent(event);
+}
+
+/**
+ * Advances the simulation by the given number of time steps, then
+ * synchronizes the bodies and emits the contact signals once.
+ */
+void Box2DCoreWorld::advance(int steps)
+{
+    if (!mWorld)
+        return;
+
+    if (mThreaded && !mShared) {
+        // Skip this frame when the previous step is still running
+        if (!mStepPending)
+            startStep(steps);
+        return;
+    }
+
+    runStep(steps);
+    finishStep();
+}
+
+/**
+ * Waits for the step running on the physics thread, if any, and applies its
+ * results right away instead of when the queued stepFinished() arrives.
+ */
+void Box2DCoreWorld::completeStep()
+{
+    if (!mStepPending)
+        return;
+
+    waitForStep();
+    ++mCompletedSteps;
+    finishStep();
+}
+
+/**
+ * Finishes a step that ran on the physics thread, unless completeStep() was
+ * already called for it.
+ */
+void Box2DCoreWorld::stepFinished()
+{
+    if (mCompletedSteps > 0)
+        --mCompletedSteps;
+    else
+        finishStep();
+}
+
+void Box2DCoreWorld::startStep(int steps)
+{
+    mStepPending = true;
+    mStepPool->start(new StepJob(this, steps));
+}
+
+static inline bool sameTransform(const b2Transform &a, const b2Transform &b)
+{
+    return a.p.x == b.p.x && a.p.y == b.p.y && a.q.s == b.q.s && a.q.c == b.q.c;
+}
+
+/**
+ * Performs the steps and writes the resulting body transforms to the back
+ * buffer. In threaded mode this runs on the physics thread, so it only
+ * touches the b2World and never the wrapper items.
+ */
+void Box2DCoreWorld::runStep(int steps)
+{
+    const bool interpolate = interpolationActive();
+
+    for (int i = 0; i < steps - 1; ++i) {
+        mWorld->Step(mTimeStep, mVelocityIterations, mPositionIterations);
+        saveState();
+    }
+
+    // Remember where the bodies were before the last step
+    if (interpolate) {
+        mPreviousTransforms.resize(0);
+        for (b2Body *b = mWorld->GetBodyList(); b; b = b->GetNext())
+            mPreviousTransforms.append(b->GetTransform());
+    }
+
+    if (steps > 0) {
+        mWorld->Step(mTimeStep, mVelocityIterations, mPositionIterations);
+        saveState();
+    }
+
+    if (mDeterministic)
+        mStateHash = computeStateHash();
+
+    // Only the bodies that moved since their item was last updated are
+    // written to the back buffer. The stored transforms of the bodies are
+    // not changed while a step is running, so they can be read here.
+    // Bodies are not added or removed during a step, so the body list is
+    // still in the same order.
+    mBackBuffer.resize(0);
+    mAwakeBodyCount = 0;
+    int index = 0;
+    for (b2Body *b = mWorld->GetBodyList(); b; b = b->GetNext(), ++index) {
+        if (b->GetType() == b2_staticBody)
+            continue;
+
+        if (b->IsAwake() && b->IsActive())
+            ++mAwakeBodyCount;
+
+        Box2DBody *body = static_cast<Box2DBody*>(b->GetUserData());
+        if (!body)
+            continue;
+
+        const b2Transform &transform = b->GetTransform();
+        if (sameTransform(transform, body->mTransform)
+                && sameTransform(body->mPreviousTransform, body->mTransform))
+            continue;
+
+        BodyState state;
+        state.body = body;
+        state.current = transform;
+        state.previous = interpolate ? mPreviousTransforms.at(index) : transform;
+        state.angle = b->GetAngle();
+        mBackBuffer.append(state);
+    }
+}
+
+/**
+ * Called on the GUI thread once the steps are done. Swaps in the new
+ * transforms and applies them to the bodies.
+ */
+void Box2DCoreWorld::finishStep()
+{
+    mFrontBuffer.swap(mBackBuffer);
+    mStepPending = false;
+    ++mStepCount;
+
+    const bool interpolate = interpolationActive();
+    int synchronized = 0;
+
+    for (int i = 0; i < mFrontBuffer.count(); ++i) {
+        const BodyState &state = mFrontBuffer.at(i);
+        Box2DBody *body = state.body;
+        const bool wasOutside = body->mOutsideFocus;
+
+        updateFocus(body, state.current.p);
+
+        if (!body->mOutsideFocus) {
+            // Interpolated bodies are shown blended on the next frame
+            body->setTransforms(state.previous, state.current, state.angle);
+            if (!interpolate)
+                body->synchronize(state.current.p, state.angle);
+            ++synchronized;
+            continue;
+        }
+
+        // Deactivated bodies do not move, so they only need a last update.
+        // The others are spread over the steps of the interval.
+        const bool update = mOutsideFocusPolicy == ReduceRate
+                ? (mStepCount + i) % mReducedRateInterval == 0
+                : !wasOutside;
+        if (update) {
+            body->setTransforms(state.current, state.current, state.angle);
+            body->synchronize(state.current.p, state.angle);
+            ++synchronized;
+        }
+    }
+
+    mSynchronizedBodyCount = synchronized;
+    updateTransforms();
+
+    if (mRenderOnlyTransforms && mPropertyUpdateInterval > 0
+            && mStepCount % mPropertyUpdateInterval == 0)
+        commitTransforms();
+    setBodyCounts(mBodies.count() - mOutsideBodyCount, mOutsideBodyCount);
+
+    // Changes made by the handlers are applied once they have all been called
+    mDispatching = true;
+
+    // A handler may remove bodies from the list
+    for (int i = 0; i < mObservedBodies.count(); ++i)
+        mObservedBodies.at(i)->emitObservedChanges();
+
+    emitContactSignals();
+    emit stepped();
+    mDispatching = false;
+
+    flushCommands();
+
+    if (mSuspendWhenIdle && mAwakeBodyCount == 0 && !mIdle) {
+        mIdle = true;
+        emit idleChanged();
+        updateStepping();
+    }
+}
+
+void Box2DCoreWorld::emitContactSignals()
+{
+    // Emit contact signals. Handlers may clear the fixtures of later events.
+    const QList<ContactEvent> &events = mContactListener->events();
+    for (int i = 0; i < events.count(); ++i) {
+        const ContactEvent event = events.at(i);
+        if (!event.fixtureA || !event.fixtureB)
+            continue;
+
+        switch (event.type) {
+        case ContactEvent::BeginContact:
+            event.fixtureA->emitBeginContact(event.fixtureB);
+            event.fixtureB->emitBeginContact(event.fixtureA);
+            break;
+        case ContactEvent::EndContact:
+            event.fixtureA->emitEndContact(event.fixtureB);
+            event.fixtureB->emitEndContact(event.fixtureA);
+            break;
+        }
+    }
+    mContactListener->clearEvents();
+
+    // Emit signals for the current state of the contacts
+    b2Contact *contact = mWorld->GetContactList();
+    while (contact) {
+        Box2DFixture *fixtureA = toBox2DFixture(contact->GetFixtureA());
+        Box2DFixture *fixtureB = toBox2DFixture(contact->GetFixtureB());
+
+        if (fixtureA && fixtureB) {
+            fixtureA->emitContactChanged(fixtureB);
+            fixtureB->emitContactChanged(fixtureA);
+        }
+
+        contact = contact->GetNext();
+    }
+}
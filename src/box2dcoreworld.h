@@ -0,0 +1,612 @@
+/*
+ * box2dcoreworld.h
+ * Copyright (c) 2010 Thorbjørn Lindeijer <thorbjorn@lindeijer.nl>
+ * Copyright (c) 2011 Joonas Erkinheimo <joonas.erkinheimo@nokia.com>
+ * Copyright (c) 2012 Adriano Rezende <atdrez@gmail.com>
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DCOREWORLD_H
+#define BOX2DCOREWORLD_H
+
+#include <QObject>
+#include <QQmlParserStatus>
+#include <QQmlListProperty>
+#include <qqml.h>
+#include <QList>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QVariant>
+#include <QBasicTimer>
+#include <Box2D.h>
+
+class Box2DBody;
+class Box2DFixture;
+class Box2DJoint;
+class Box2DLightBody;
+class Box2DLightFixture;
+class ContactListener;
+class Box2DDestructionListener;
+
+class QThreadPool;
+
+class b2World;
+class b2WorldState;
+
+// TODO: Maybe turn this into a property of the world, though it can't be
+// changed dynamically.
+static const float scaleRatio = 32.0f; // 32 pixels in one meter
+
+/**
+ * The simulation behind a World: the b2World, its bodies, the stepping and
+ * the contact signals. It does not depend on a window or a scene, so it can
+ * also be used on its own, for example on a game server.
+ */
+class Box2DCoreWorld : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_ENUMS(OutsideFocusPolicy)
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
+    Q_PROPERTY(float timeStep READ timeStep WRITE setTimeStep)
+    Q_PROPERTY(int velocityIterations READ velocityIterations WRITE setVelocityIterations)
+    Q_PROPERTY(int positionIterations READ positionIterations WRITE setPositionIterations)
+    Q_PROPERTY(int frameTime READ frameTime WRITE setFrameTime)
+    Q_PROPERTY(QPointF gravity READ gravity WRITE setGravity NOTIFY gravityChanged)
+    Q_PROPERTY(bool threaded READ isThreaded WRITE setThreaded NOTIFY threadedChanged)
+    Q_PROPERTY(bool shared READ isShared WRITE setShared NOTIFY sharedChanged)
+    Q_PROPERTY(bool suspendWhenIdle READ suspendWhenIdle WRITE setSuspendWhenIdle NOTIFY suspendWhenIdleChanged)
+    Q_PROPERTY(bool idle READ isIdle NOTIFY idleChanged)
+    Q_PROPERTY(QRectF focusRect READ focusRect WRITE setFocusRect NOTIFY focusRectChanged)
+    Q_PROPERTY(OutsideFocusPolicy outsideFocusPolicy READ outsideFocusPolicy WRITE setOutsideFocusPolicy NOTIFY outsideFocusPolicyChanged)
+    Q_PROPERTY(int reducedRateInterval READ reducedRateInterval WRITE setReducedRateInterval NOTIFY reducedRateIntervalChanged)
+    Q_PROPERTY(int fullRateBodyCount READ fullRateBodyCount NOTIFY bodyCountsChanged)
+    Q_PROPERTY(int reducedRateBodyCount READ reducedRateBodyCount NOTIFY bodyCountsChanged)
+    Q_PROPERTY(int synchronizedBodyCount READ synchronizedBodyCount NOTIFY stepped)
+    Q_PROPERTY(bool renderOnlyTransforms READ renderOnlyTransforms WRITE setRenderOnlyTransforms NOTIFY renderOnlyTransformsChanged)
+    Q_PROPERTY(int propertyUpdateInterval READ propertyUpdateInterval WRITE setPropertyUpdateInterval NOTIFY propertyUpdateIntervalChanged)
+    Q_PROPERTY(QByteArray transforms READ transforms NOTIFY stepped)
+    Q_PROPERTY(int rollbackFrames READ rollbackFrames WRITE setRollbackFrames NOTIFY rollbackFramesChanged)
+    Q_PROPERTY(bool deterministic READ isDeterministic WRITE setDeterministic NOTIFY deterministicChanged)
+    Q_PROPERTY(QString stateHash READ stateHashString NOTIFY stepped)
+    Q_PROPERTY(bool asynchronous READ isAsynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(QQmlListProperty<Box2DBody> bodies READ bodies)
+    Q_CLASSINFO("DefaultProperty", "bodies")
+
+public:
+    enum OutsideFocusPolicy {
+        ReduceRate = 0,
+        Deactivate
+    };
+
+    /**
+     * The number of floats per body in the transforms: the index of the body
+     * in bodies, position x and y, rotation, linear velocity x and y and
+     * angular velocity.
+     */
+    static const int TransformSize = 7;
+
+    explicit Box2DCoreWorld(QObject *parent = 0);
+    ~Box2DCoreWorld();
+
+    /**
+     * The amount of time to step through each frame in seconds.
+     * By default it is 1 / 60.
+     */
+    float timeStep() const { return mTimeStep; }
+    void setTimeStep(float timeStep) { mTimeStep = timeStep; }
+
+    bool isRunning() const { return mIsRunning; }
+    void setRunning(bool running);
+
+    /**
+     * The number of velocity iterations used to process one step.
+     * 10 by default.
+     */
+    int velocityIterations() const
+    { return mVelocityIterations; }
+
+    void setVelocityIterations(int iterations)
+    { mVelocityIterations = iterations; }
+
+
+    /**
+     * The number of position iterations used to process one step.
+     * 10 by default.
+     */
+    int positionIterations() const
+    { return mPositionIterations; }
+
+    void setPositionIterations(int iterations)
+    { mPositionIterations = iterations; }
+
+    /**
+     * The amount of time each frame takes in milliseconds.
+     * By default it is 1000 / 60.
+     */
+    int frameTime() const { return mFrameTime; }
+    void setFrameTime(int frameTime) { mFrameTime = frameTime; }
+
+    QPointF gravity() const { return mGravity; }
+    void setGravity(const QPointF &gravity);
+
+    /**
+     * Whether the world is stepped on a dedicated physics thread. The GUI
+     * thread then only applies the transforms computed by the last step.
+     * False by default.
+     */
+    bool isThreaded() const { return mThreaded; }
+    void setThreaded(bool threaded);
+
+    /**
+     * Whether the world is stepped by the process-wide scheduler, in
+     * parallel with the other shared worlds. False by default.
+     */
+    bool isShared() const { return mShared; }
+    void setShared(bool shared);
+
+    /**
+     * Whether the world stops stepping while all of its bodies are asleep.
+     * False by default.
+     */
+    bool suspendWhenIdle() const { return mSuspendWhenIdle; }
+    void setSuspendWhenIdle(bool suspendWhenIdle);
+
+    /**
+     * Whether stepping is suspended because all bodies are asleep.
+     */
+    bool isIdle() const { return mIdle; }
+
+    Q_INVOKABLE void wakeUp();
+
+    /**
+     * The area in which bodies are updated every step, in the coordinates of
+     * the world. An empty rectangle, the default, updates all bodies.
+     */
+    QRectF focusRect() const { return mFocusRect; }
+    void setFocusRect(const QRectF &focusRect);
+
+    /**
+     * What happens to bodies outside of the focusRect. Deactivate by default.
+     * ReduceRate only lowers the rate at which their items are updated, the
+     * bodies are still solved every step.
+     */
+    OutsideFocusPolicy outsideFocusPolicy() const { return mOutsideFocusPolicy; }
+    void setOutsideFocusPolicy(OutsideFocusPolicy outsideFocusPolicy);
+
+    /**
+     * Every how many steps the items of bodies outside of the focusRect are
+     * updated, with the ReduceRate policy. 4 by default.
+     */
+    int reducedRateInterval() const { return mReducedRateInterval; }
+    void setReducedRateInterval(int reducedRateInterval);
+
+    /**
+     * The number of bodies inside and outside of the focusRect, as of the
+     * last step.
+     */
+    int fullRateBodyCount() const { return mFullRateBodyCount; }
+    int reducedRateBodyCount() const { return mReducedRateBodyCount; }
+
+    /**
+     * The number of bodies whose item was updated by the last step. Only
+     * bodies that moved are updated.
+     */
+    int synchronizedBodyCount() const { return mSynchronizedBodyCount; }
+
+    /**
+     * Whether the steps only move the rendered bodies, leaving their x, y
+     * and rotation properties to be updated every propertyUpdateInterval
+     * steps or by commitTransforms(). False by default.
+     */
+    bool renderOnlyTransforms() const { return mRenderOnlyTransforms; }
+    void setRenderOnlyTransforms(bool renderOnlyTransforms);
+
+    /**
+     * Every how many steps the properties of the bodies are updated with
+     * renderOnlyTransforms. 0, the default, only updates them on demand.
+     */
+    int propertyUpdateInterval() const { return mPropertyUpdateInterval; }
+    void setPropertyUpdateInterval(int propertyUpdateInterval);
+
+    Q_INVOKABLE void commitTransforms();
+
+    QByteArray transforms() const;
+    Q_INVOKABLE Box2DBody *bodyAt(int index) const;
+
+    /**
+     * The bodies that moved in the last step, transformCount() *
+     * TransformSize floats. Valid until the next step.
+     */
+    const float *transformData() const { return mTransforms.constData(); }
+    int transformCount() const { return mTransforms.count() / TransformSize; }
+
+    /**
+     * How many steps the world keeps the state of, so that it can be rewound
+     * by up to that many steps. 0, the default, keeps no history.
+     */
+    int rollbackFrames() const { return mRollbackFrames; }
+    void setRollbackFrames(int rollbackFrames);
+
+    Q_INVOKABLE bool rewind(int steps);
+
+    /**
+     * Whether contacts are processed in an order that only depends on the
+     * order in which bodies and fixtures were created, and the state hash is
+     * computed after each step. False by default.
+     */
+    bool isDeterministic() const { return mDeterministic; }
+    void setDeterministic(bool deterministic);
+
+    /**
+     * A 64-bit hash of the positions and velocities of all bodies after the
+     * last step. Only computed in deterministic mode.
+     */
+    quint64 stateHash() const { return mStateHash; }
+    QString stateHashString() const;
+
+    /**
+     * Whether the b2World and the bodies declared in the world are created
+     * on a worker thread when the component is complete, instead of on the
+     * GUI thread. Only read at that time. False by default.
+     */
+    bool isAsynchronous() const { return mAsynchronous; }
+    void setAsynchronous(bool asynchronous);
+
+    /**
+     * Whether the world is still being built on the worker thread. ready()
+     * is emitted once it is done.
+     */
+    bool isLoading() const { return mBuild != 0; }
+
+    QQmlListProperty<Box2DBody> bodies();
+
+    void classBegin();
+    void componentComplete();
+    bool isComponentComplete() const { return mComponentComplete; }
+
+    void registerBody(Box2DBody *body);
+    void releaseBody(Box2DBody *body);
+    void observeBody(Box2DBody *body);
+
+    /**
+     * Lets the owner decide when to step, by calling advance(), instead of
+     * the timer of the world. Used by the World item to step with the render
+     * loop.
+     */
+    void setExternalStepping(bool externalStepping);
+
+    /**
+     * Stops stepping without changing the running property, for example
+     * while the window of the world is hidden.
+     */
+    void setPaused(bool paused);
+
+    /**
+     * Whether the transforms before and after each step are kept, so that
+     * they can be blended by interpolateBodies(). Only has an effect with
+     * external stepping.
+     */
+    void setInterpolating(bool interpolating);
+
+    Q_INVOKABLE void advance(int steps);
+    void interpolateBodies(float32 alpha);
+
+    /**
+     * Whether a step is running on the physics thread, or its results are
+     * still waiting to be applied.
+     */
+    bool isStepPending() const { return mStepPending; }
+
+    /**
+     * Blocks until a step running on the physics thread has finished. Does
+     * nothing when the world is not threaded.
+     */
+    void waitForStep() const;
+
+    /**
+     * Whether changes to the b2World are deferred, because a step is running
+     * or the signals of the last step are being emitted. Deferred changes
+     * are applied together once the step is finished.
+     */
+    bool isLocked() const;
+
+    void createBody(Box2DBody *body);
+    void destroyBody(b2Body *body);
+    void setBodyTransform(Box2DBody *body, const b2Vec2 &position, float32 angle);
+    void setBodyLinearVelocity(Box2DBody *body, const b2Vec2 &velocity);
+    void setBodyAngularVelocity(Box2DBody *body, float32 velocity);
+    void setBodyAwake(Box2DBody *body, bool awake);
+    void setBodyActive(Box2DBody *body, bool active);
+    void updateBody(Box2DBody *body);
+    void updateBody(Box2DLightBody *body);
+    void applyForce(Box2DBody *body, const b2Vec2 &force, const b2Vec2 &point);
+    void applyForceToCenter(Box2DBody *body, const b2Vec2 &force);
+    void applyLinearImpulse(Box2DBody *body, const b2Vec2 &impulse,
+                            const b2Vec2 &point);
+    void applyTorque(Box2DBody *body, float32 torque);
+    void reshapeFixture(Box2DFixture *fixture, b2Shape *shape);
+    void updateFixture(Box2DFixture *fixture);
+    void updateFixture(Box2DLightFixture *fixture);
+    void createJoint(Box2DJoint *joint);
+    void destroyJoint(b2Joint *joint);
+    void updateJoint(Box2DJoint *joint);
+    void cancelCommands(Box2DJoint *joint);
+
+    Q_INVOKABLE int createBodies(Box2DLightBody *prototype,
+                                 const QVariant &positions);
+    int createBodies(Box2DLightBody *prototype, const float *positions,
+                     int count);
+    Q_INVOKABLE void destroyBodies(int handle, int count);
+    Q_INVOKABLE QPointF handlePosition(int handle) const;
+    void setHandleTransform(int handle, const b2Vec2 &position, float32 angle);
+
+    /**
+     * The b2Body of a handle returned by createBodies(), or 0 when it was
+     * destroyed or is still waiting for a step to finish.
+     */
+    b2Body *handleBody(int handle) const
+    { return handle >= 0 && handle < mHandles.count() ? mHandles.at(handle) : 0; }
+
+    void createBody(Box2DLightBody *body);
+    void setBodyTransform(Box2DLightBody *body, const b2Vec2 &position,
+                          float32 angle);
+    void setBodyLinearVelocity(Box2DLightBody *body, const b2Vec2 &velocity);
+    void applyForce(Box2DLightBody *body, const b2Vec2 &force,
+                    const b2Vec2 &point);
+    void applyLinearImpulse(Box2DLightBody *body, const b2Vec2 &impulse,
+                            const b2Vec2 &point);
+    void cancelCommands(Box2DLightBody *body);
+
+    b2World *world() const { return mWorld; }
+
+    /**
+     * Returns a deep copy of the b2World as of the last finished step, for
+     * simulating ahead without affecting this world. The copy has no
+     * listeners, so it can be stepped on any thread without touching the
+     * bodies of this world. Changes still waiting for the step to finish are
+     * not included. The caller takes ownership.
+     */
+    b2World *cloneWorld();
+
+    Q_INVOKABLE QVariantList predictTrajectory(Box2DBody *body,
+                                               const QPointF &impulse,
+                                               int steps);
+
+private slots:
+    void unregisterBody();
+    void fixtureDestroyed(Box2DFixture *fixture);
+    void finishStep();
+    void stepFinished();
+    void finishBuild();
+
+signals:
+    void gravityChanged();
+    void runningChanged();
+    void threadedChanged();
+    void sharedChanged();
+    void suspendWhenIdleChanged();
+    void idleChanged();
+    void focusRectChanged();
+    void outsideFocusPolicyChanged();
+    void reducedRateIntervalChanged();
+    void bodyCountsChanged();
+    void rollbackFramesChanged();
+    void deterministicChanged();
+    void renderOnlyTransformsChanged();
+    void propertyUpdateIntervalChanged();
+    void stepped();
+    void initialized();
+    void asynchronousChanged();
+    void loadingChanged();
+    void ready();
+
+protected:
+    void timerEvent(QTimerEvent *);
+
+private:
+    friend class StepJob;
+    friend class BuildJob;
+    friend class ScheduledStep;
+    friend class Box2DScheduler;
+    friend class BatchStep;
+    friend class Box2DWorldBatch;
+    friend class ShardStep;
+    friend class Box2DShardedWorld;
+
+    /**
+     * Transform of a body before and after the last step.
+     */
+    struct BodyState {
+        Box2DBody *body;
+        b2Transform previous;
+        b2Transform current;
+        float32 angle;
+    };
+
+    /**
+     * The definitions shared by bodies created by createBodies(). Owns the
+     * shapes of the fixture definitions.
+     */
+    struct BodyTemplate {
+        ~BodyTemplate();
+
+        b2BodyDef bodyDef;
+        QVector<b2FixtureDef> fixtureDefs;
+        QVector<float> positions;
+    };
+
+    /**
+     * Consecutive handles that were released by destroyBodies().
+     */
+    struct HandleRange {
+        int first;
+        int count;
+    };
+
+    /**
+     * The definitions of the bodies and fixtures of a world being built on
+     * the worker thread, and the b2World built from them.
+     */
+    struct WorldBuild;
+
+    /**
+     * A change to the b2World, kept until no step is running.
+     */
+    struct Command {
+        enum Type {
+            CreateBody,
+            DestroyBody,
+            SetTransform,
+            SetLinearVelocity,
+            SetAngularVelocity,
+            SetAwake,
+            SetActive,
+            ApplyForce,
+            ApplyForceToCenter,
+            ApplyLinearImpulse,
+            ApplyTorque,
+            ReshapeFixture,
+            CreateJoint,
+            DestroyJoint,
+            SetGravity,
+            Rewind,
+            CreateBodies,
+            DestroyBodies,
+            UpdateBody,
+            UpdateFixture,
+            UpdateJoint
+        };
+
+        explicit Command(Type type = SetGravity)
+            : type(type), body(0), lightBody(0), b2body(0), fixture(0),
+              lightFixture(0), shape(0), joint(0), b2joint(0), bodyTemplate(0), value(0),
+              steps(0), handle(-1), count(0), flag(false) {}
+
+        Type type;
+        Box2DBody *body;
+        Box2DLightBody *lightBody;
+        b2Body *b2body;
+        Box2DFixture *fixture;
+        Box2DLightFixture *lightFixture;
+        b2Shape *shape;
+        Box2DJoint *joint;
+        b2Joint *b2joint;
+        BodyTemplate *bodyTemplate;
+        b2Vec2 vector;
+        b2Vec2 point;
+        float32 value;
+        int steps;
+        int handle;
+        int count;
+        bool flag;
+    };
+
+    void updateStepping();
+    void setupWorld(b2World *world);
+    void startBuild();
+    void forgetBody(Box2DBody *body);
+    void startStep(int steps);
+    void runStep(int steps);
+    void completeStep();
+    bool interpolationActive() const;
+    void emitContactSignals();
+    void submit(const Command &command);
+    void apply(const Command &command);
+    void flushCommands();
+    void discardCommands();
+    void detachBody(b2Body *body);
+    void updateFocus(Box2DBody *body, const b2Vec2 &position);
+    void refocus();
+    void setBodyCounts(int fullRateBodyCount, int reducedRateBodyCount);
+    void updateTransforms();
+    void saveState();
+    void restoreState(int steps);
+    void clearHistory();
+    quint64 computeStateHash() const;
+    int takeHandles(int count);
+    void releaseHandles(int first, int count);
+
+    static void append_body(QQmlListProperty<Box2DBody> *list,
+                            Box2DBody *body);
+    static int count_body(QQmlListProperty<Box2DBody> *list);
+    static Box2DBody *at_body(QQmlListProperty<Box2DBody> *list, int index);
+
+    b2World *mWorld;
+    ContactListener *mContactListener;
+    Box2DDestructionListener *mDestructionListener;
+    float mTimeStep;
+    int mVelocityIterations;
+    int mPositionIterations;
+    int mFrameTime;
+    QPointF mGravity;
+    bool mIsRunning;
+    bool mComponentComplete;
+    QBasicTimer mTimer;
+    QList<Box2DBody*> mBodies;
+    QList<Box2DBody*> mObservedBodies;
+    bool mThreaded;
+    bool mShared;
+    bool mStepPending;
+    int mCompletedSteps;
+    QThreadPool *mStepPool;
+    QVector<BodyState> mFrontBuffer;
+    QVector<BodyState> mBackBuffer;
+    QVector<b2Transform> mPreviousTransforms;
+    QVector<float> mTransforms;
+    QVector<b2Body*> mHandles;
+    QVector<HandleRange> mFreeHandles;
+    bool mExternalStepping;
+    bool mPaused;
+    bool mInterpolating;
+    bool mSuspendWhenIdle;
+    bool mIdle;
+    int mAwakeBodyCount;
+    QBasicTimer mIdleTimer;
+    QList<Command> mCommands;
+    bool mDispatching;
+    QRectF mFocusRect;
+    OutsideFocusPolicy mOutsideFocusPolicy;
+    int mReducedRateInterval;
+    int mFullRateBodyCount;
+    int mReducedRateBodyCount;
+    int mStepCount;
+    int mRollbackFrames;
+    QVector<b2WorldState*> mHistory;
+    int mHistoryHead;
+    int mHistoryCount;
+    bool mDeterministic;
+    quint64 mStateHash;
+    int mOutsideBodyCount;
+    int mSynchronizedBodyCount;
+    bool mRenderOnlyTransforms;
+    int mPropertyUpdateInterval;
+    bool mAsynchronous;
+    WorldBuild *mBuild;
+    QThreadPool *mBuildPool;
+};
+
+QML_DECLARE_TYPE(Box2DCoreWorld)
+
+#endif // BOX2DCOREWORLD_H
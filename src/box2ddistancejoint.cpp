@@ -118,7 +118,6 @@ Box2DDistanceJoint::~Box2DDistanceJoint()
 */
 float Box2DDistanceJoint::length() const
 {
-    if(mDistanceJoint) return mDistanceJoint->GetLength();
     return mDistanceJointDef.length;
 }
 
@@ -127,8 +126,7 @@ void Box2DDistanceJoint::setLength(float _length)
     if (qFuzzyCompare(length(),_length / scaleRatio))
         return;
     mDistanceJointDef.length = _length / scaleRatio;
-    if (mDistanceJoint)
-        mDistanceJoint->SetLength(mDistanceJointDef.length);
+    updateJoint();
     emit lengthChanged();
 }
 
@@ -141,7 +139,6 @@ DistanceJoint should be less than 30Hz.
 */
 float Box2DDistanceJoint::frequencyHz() const
 {
-    if(mDistanceJoint) return mDistanceJoint->GetFrequency();
     return mDistanceJointDef.frequencyHz;
 }
 
@@ -150,8 +147,7 @@ void Box2DDistanceJoint::setFrequencyHz(float _frequencyHz)
     if (frequencyHz() == _frequencyHz)
         return;
     mDistanceJointDef.frequencyHz = _frequencyHz;
-    if (mDistanceJoint)
-        mDistanceJoint->SetFrequency(_frequencyHz);
+    updateJoint();
     emit frequencyHzChanged();
 }
 
@@ -163,7 +159,6 @@ The dampingRatio is non-dimensional and is typically between 0 and 1,
 */
 float Box2DDistanceJoint::dampingRatio() const
 {
-    if(mDistanceJoint) mDistanceJoint->GetDampingRatio();
     return mDistanceJointDef.dampingRatio;
 }
 
@@ -173,8 +168,7 @@ void Box2DDistanceJoint::setDampingRatio(float _dampingRatio)
         return;
 
     mDistanceJointDef.dampingRatio = _dampingRatio;
-    if (mDistanceJoint)
-        mDistanceJoint->SetDampingRatio(_dampingRatio);
+    updateJoint();
     emit dampingRatioChanged();
 }
 
@@ -238,6 +232,13 @@ void Box2DDistanceJoint::createJoint()
     emit created();
 }
 
+void Box2DDistanceJoint::updateJointFromDef()
+{
+    mDistanceJoint->SetLength(mDistanceJointDef.length);
+    mDistanceJoint->SetFrequency(mDistanceJointDef.frequencyHz);
+    mDistanceJoint->SetDampingRatio(mDistanceJointDef.dampingRatio);
+}
+
 void Box2DDistanceJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -246,7 +247,7 @@ void Box2DDistanceJoint::cleanup(b2World *world)
     }
     if (mDistanceJoint && bodyA() && bodyB()) {
         mDistanceJoint->SetUserData(0);
-        world->DestroyJoint(mDistanceJoint);
+        destroyJoint(world, mDistanceJoint);
         mDistanceJoint = 0;
     }
 }
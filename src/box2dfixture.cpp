@@ -26,7 +26,8 @@
  */
 
 #include "box2dfixture.h"
-#include "box2dworld.h"
+#include "box2dcoreworld.h"
+#include "box2dbody.h"
 #include <QDebug>
 #include "Common/b2Math.h"
 
@@ -37,6 +38,8 @@ Box2DFixture::Box2DFixture(QQuickItem *parent) :
     QQuickItem(parent),
     mFixture(0),
     mFixtureDef(),
+    mBody(0),
+    mDirty(false),
     factorWidth(1.0),
     factorHeight(1.0)
 {
@@ -167,8 +170,9 @@ void Box2DFixture::setDensity(float density)
         return;
 
     mFixtureDef.density = density;
+    mDirty = true;
     if (mFixture)
-        mFixture->SetDensity(density);
+        updateFixture();
     emit densityChanged();
 }
 
@@ -213,8 +217,9 @@ void Box2DFixture::setFriction(float friction)
         return;
 
     mFixtureDef.friction = friction;
+    mDirty = true;
     if (mFixture)
-        mFixture->SetFriction(friction);
+        updateFixture();
     emit frictionChanged();
 }
 
@@ -255,8 +260,9 @@ void Box2DFixture::setRestitution(float restitution)
         return;
 
     mFixtureDef.restitution = restitution;
+    mDirty = true;
     if (mFixture)
-        mFixture->SetRestitution(restitution);
+        updateFixture();
     emit restitutionChanged();
 }
 
@@ -275,8 +281,9 @@ void Box2DFixture::setSensor(bool sensor)
         return;
 
     mFixtureDef.isSensor = sensor;
+    mDirty = true;
     if (mFixture)
-        mFixture->SetSensor(sensor);
+        updateFixture();
     emit sensorChanged();
 }
 
@@ -295,6 +302,7 @@ void Box2DFixture::setCategories(CategoryFlags layers)
         return;
 
     mFixtureDef.filter.categoryBits = layers;
+    mDirty = true;
     emit categoriesChanged();
 }
 
@@ -313,6 +321,7 @@ void Box2DFixture::setCollidesWith(CategoryFlags layers)
         return;
 
     mFixtureDef.filter.maskBits = layers;
+    mDirty = true;
     emit collidesWithChanged();
 }
 
@@ -331,6 +340,7 @@ void Box2DFixture::setGroupIndex(int groupIndex)
         return;
 
     mFixtureDef.filter.groupIndex = groupIndex;
+    mDirty = true;
     emit groupIndexChanged();
 }
 
@@ -347,18 +357,33 @@ void Box2DFixture::createFixture(b2Body *body)
     delete shape;
 }
 
+/**
+ * Like createShape(), but a polygon is returned without its convex hull,
+ * which is computed by passing the vertices stored in hull to
+ * b2PolygonShape::Set(). Lets a world that is built on a worker thread do
+ * that there. Other shapes leave hull empty.
+ */
+b2Shape *Box2DFixture::createDeferredShape(QVector<b2Vec2> *hull)
+{
+    Q_UNUSED(hull);
+    return createShape();
+}
+
 /*!
 \qmlsignal Fixture::GetBody()
 DOCME
 */
 Box2DBody *Box2DFixture::GetBody() const
 {
+    if (!mBody)
+        return 0;
     return static_cast<Box2DBody *>(mBody->GetUserData());
 }
 
 void Box2DFixture::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
 {
     if(!isComponentComplete()) return;
+    mDirty = true;
 
     qreal nw = newGeometry.width();
     qreal nh = newGeometry.height();
@@ -388,7 +413,39 @@ void Box2DFixture::emitEndContact(Box2DFixture *other)
     emit endContact(other);
 }
 
+Box2DCoreWorld *Box2DFixture::coreWorld() const
+{
+    if (Box2DBody *body = GetBody())
+        return body->coreWorld();
+    return 0;
+}
+
+/**
+ * Passes a change of the definition on to the b2Fixture through the world,
+ * which defers it while a step is running.
+ */
+void Box2DFixture::updateFixture()
+{
+    if (Box2DCoreWorld *world = coreWorld())
+        world->updateFixture(this);
+}
+
 void Box2DFixture::applyShape(b2Shape *shape)
+{
+    Box2DCoreWorld *world = coreWorld();
+    if (!world || !mBody) {
+        delete shape;
+        return;
+    }
+
+    world->reshapeFixture(this, shape);
+}
+
+/**
+ * Recreates the b2Fixture with the given shape. Called by the world once no
+ * step is running, see World::reshapeFixture().
+ */
+void Box2DFixture::replaceShape(b2Shape *shape)
 {
     if(mFixture) mBody->DestroyFixture(mFixture);
     mFixtureDef.shape = shape;
@@ -584,6 +641,19 @@ Your visual representation can be larger than the polygon to hide any gaps.
 \class Box2DPolygon
 */
 b2Shape *Box2DPolygon::createShape()
+{
+    QVector<b2Vec2> hull;
+    b2PolygonShape *shape = static_cast<b2PolygonShape*>(createDeferredShape(&hull));
+    if (shape)
+        shape->Set(hull.constData(), hull.count());
+    return shape;
+}
+
+/**
+ * Checks the vertices and returns an empty polygon, leaving the computation
+ * of its convex hull from the vertices to the caller.
+ */
+b2Shape *Box2DPolygon::createDeferredShape(QVector<b2Vec2> *hull)
 {
     const int count = mVertices.length();
     if (count < 2 || count > b2_maxPolygonVertices) {
@@ -591,24 +661,22 @@ b2Shape *Box2DPolygon::createShape()
         return 0;
     }
 
-    b2Vec2 *vertices = new b2Vec2[count];
+    hull->resize(count);
     for (int i = 0; i < count; ++i) {
         const QPointF &point = mVertices.at(i).toPointF();
-        vertices[i].Set(point.x() / scaleRatio, -point.y() / scaleRatio);
+        (*hull)[i].Set(point.x() / scaleRatio, -point.y() / scaleRatio);
         if(i > 0)
         {
-            if(b2DistanceSquared(vertices[i - 1], vertices[i]) <= b2_linearSlop * b2_linearSlop)
+            if(b2DistanceSquared(hull->at(i - 1), hull->at(i)) <= b2_linearSlop * b2_linearSlop)
             {
                 qWarning() << "Polygon: vertices are too close together";
+                hull->clear();
                 return 0;
             }
         }
     }
 
-    b2PolygonShape *shape = new b2PolygonShape;
-    shape->Set(vertices, count);
-    delete[] vertices;
-    return shape;
+    return new b2PolygonShape;
 }
 
 void Box2DPolygon::scale()
@@ -30,6 +30,7 @@
 
 #include <QQuickItem>
 #include <QFlags>
+#include <QVector>
 #include <Box2D.h>
 
 #include "box2dfixture.h"
@@ -39,6 +40,7 @@ class b2Fixture;
 struct b2FixtureDef;
 class b2Shape;
 class Box2DBody;
+class Box2DCoreWorld;
 
 class Box2DFixture : public QQuickItem
 {
@@ -97,11 +99,19 @@ protected:
     b2Fixture *mFixture;
     b2FixtureDef mFixtureDef;
     b2Body * mBody;
+    /**
+     * Whether the definition or the shape changed since an asynchronous
+     * world collected them, in which case it recreates the b2Fixture.
+     */
+    bool mDirty;
     float factorWidth;
     float factorHeight;
     virtual b2Shape *createShape() = 0;
+    virtual b2Shape *createDeferredShape(QVector<b2Vec2> *hull);
     void geometryChanged(const QRectF & newGeometry, const QRectF & oldGeometry);
     void applyShape(b2Shape * shape);
+    void updateFixture();
+    Box2DCoreWorld *coreWorld() const;
 
 signals:
     void densityChanged();
@@ -118,11 +128,12 @@ signals:
 
 
 private:
-    friend class Box2DWorld;
+    friend class Box2DCoreWorld;
 
     void emitBeginContact(Box2DFixture *other);
     void emitContactChanged(Box2DFixture *other);
     void emitEndContact(Box2DFixture *other);
+    void replaceShape(b2Shape *shape);
 
 
 
@@ -164,6 +175,7 @@ public:
         if (mRadius == radius)
             return;
         mRadius = radius;
+        mDirty = true;
         scale();
         emit radiusChanged();
     }
@@ -192,6 +204,7 @@ public:
         if (vertices == mVertices)
             return;
         mVertices = vertices;
+        mDirty = true;
         emit verticesChanged();
     }
 signals:
@@ -213,6 +226,7 @@ public:
 
 protected:
     b2Shape *createShape();
+    b2Shape *createDeferredShape(QVector<b2Vec2> *hull);
 };
 
 
@@ -232,17 +246,20 @@ public:
     bool loop() const { return mLoop; }
     void setLoop(bool loop) {
         mLoop = loop;
+        mDirty = true;
         emit loopChanged();
     }
     QPointF prevVertex() const { return mPrevVertex; }
     void setPrevVertex(QPointF &prevVertex) {
         mPrevVertex = prevVertex;
         prevVertexFlag = true;
+        mDirty = true;
     }
     QPointF nextVertex() const { return mNextVertex; }
     void setNextVertex(QPointF &nextVertex) {
         mNextVertex = nextVertex;
         nextVertexFlag = true;
+        mDirty = true;
     }
 
 protected:
@@ -67,15 +67,14 @@ the maxium force that is allowed to the joint
 */
 float Box2DFrictionJoint::maxForce() const
 {
-    if(mFrictionJoint) return mFrictionJoint->GetMaxForce();
     return mFrictionJointDef.maxForce;
 }
 
 void Box2DFrictionJoint::setMaxForce(float maxForce)
 {
-    if(mFrictionJoint && mFrictionJoint->GetMaxForce() == maxForce) return;
-    if(mFrictionJoint) mFrictionJoint->SetMaxForce(maxForce);
-    else mFrictionJointDef.maxForce = maxForce;
+    if(mFrictionJointDef.maxForce == maxForce) return;
+    mFrictionJointDef.maxForce = maxForce;
+    updateJoint();
     emit maxForceChanged();
 }
 
@@ -85,15 +84,14 @@ the maxium ammount of torque that is allowed to the joint
 */
 float Box2DFrictionJoint::maxTorque() const
 {
-    if(mFrictionJoint) return mFrictionJoint->GetMaxTorque();
     return mFrictionJointDef.maxTorque;
 }
 
 void Box2DFrictionJoint::setMaxTorque(float maxTorque)
 {
-    if(mFrictionJoint && mFrictionJoint->GetMaxTorque() == maxTorque) return;
-    if(mFrictionJoint) mFrictionJoint->SetMaxForce(maxTorque);
-    else mFrictionJointDef.maxTorque = maxTorque;
+    if(mFrictionJointDef.maxTorque == maxTorque) return;
+    mFrictionJointDef.maxTorque = maxTorque;
+    updateJoint();
     emit maxTorqueChanged();
 }
 
@@ -161,6 +159,12 @@ void Box2DFrictionJoint::createJoint()
     emit created();
 }
 
+void Box2DFrictionJoint::updateJointFromDef()
+{
+    mFrictionJoint->SetMaxForce(mFrictionJointDef.maxForce);
+    mFrictionJoint->SetMaxTorque(mFrictionJointDef.maxTorque);
+}
+
 void Box2DFrictionJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -169,7 +173,7 @@ void Box2DFrictionJoint::cleanup(b2World *world)
     }
     if (mFrictionJoint && bodyA() && bodyB()) {
         mFrictionJoint->SetUserData(0);
-        world->DestroyJoint(mFrictionJoint);
+        destroyJoint(world, mFrictionJoint);
         mFrictionJoint = 0;
     }
 }
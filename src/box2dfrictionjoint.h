@@ -59,6 +59,7 @@ public:
 
     void nullifyJoint();
     void createJoint();
+    void updateJointFromDef();
     void cleanup(b2World *world);
     b2Joint * GetJoint();
 
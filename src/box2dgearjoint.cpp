@@ -99,7 +99,7 @@ void Box2DGearJoint::setRatio(float _ratio)
 {
     if(qFuzzyCompare(_ratio,ratio())) return;
     mGearJointDef.ratio = _ratio;
-    if(mGearJoint) mGearJoint->SetRatio(_ratio);
+    updateJoint();
     emit ratioChanged();
 }
 
@@ -165,6 +165,11 @@ void Box2DGearJoint::createJoint()
     emit created();
 }
 
+void Box2DGearJoint::updateJointFromDef()
+{
+    mGearJoint->SetRatio(mGearJointDef.ratio);
+}
+
 void Box2DGearJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -173,7 +178,7 @@ void Box2DGearJoint::cleanup(b2World *world)
     }
     if (mGearJoint) {
         mGearJoint->SetUserData(0);
-        world->DestroyJoint(mGearJoint);
+        destroyJoint(world, mGearJoint);
         mGearJoint = 0;
     }
 }
@@ -56,6 +56,7 @@ public:
 
     void nullifyJoint();
     void createJoint();
+    void updateJointFromDef();
     void cleanup(b2World *world);
     b2Joint * GetJoint();
 
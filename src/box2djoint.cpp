@@ -35,12 +35,19 @@ Box2DJoint::Box2DJoint(QObject *parent) :
     QObject(parent),
     mInitializePending(false),
     mWorld(0),
+    mCoreWorld(0),
     mCollideConnected(false),
     mBodyA(0),
     mBodyB(0)
 {
 }
 
+Box2DJoint::~Box2DJoint()
+{
+    if (mCoreWorld)
+        mCoreWorld->cancelCommands(this);
+}
+
 /*!
     \qmltype Joint
     \instantiates Box2DJoint
@@ -201,10 +208,13 @@ void Box2DJoint::initialize()
         mInitializePending = true;
         return;
     }
-    if(mBodyA->world() != mBodyB->world())
+    if(mBodyA->world() != mBodyB->world()) {
         qWarning() << "bodyA and bodyB from different worlds";
-    else
-        createJoint();
+        return;
+    }
+
+    mCoreWorld = mBodyA->coreWorld();
+    mCoreWorld->createJoint(this);
 }
 
 
@@ -216,6 +226,33 @@ b2World *Box2DJoint::world() const
     return NULL;
 }
 
+/**
+ * Destroys the b2Joint through the world, which defers it while a step is
+ * running.
+ */
+void Box2DJoint::destroyJoint(b2World *world, b2Joint *joint)
+{
+    if (mCoreWorld)
+        mCoreWorld->destroyJoint(joint);
+    else
+        world->DestroyJoint(joint);
+}
+
+/**
+ * Passes a change of the definition on to the b2Joint through the world,
+ * which defers it while a step is running.
+ */
+void Box2DJoint::updateJoint()
+{
+    if (!GetJoint())
+        return;
+
+    if (mCoreWorld)
+        mCoreWorld->updateJoint(this);
+    else
+        updateJointFromDef();
+}
+
 void Box2DJoint::bodyACreated()
 {
     mBodyA = static_cast<Box2DBody*>(sender());
@@ -34,6 +34,7 @@
 class b2World;
 class Box2DBody;
 class Box2DWorld;
+class Box2DCoreWorld;
 
 class Box2DJoint : public QObject
 {
@@ -45,6 +46,7 @@ class Box2DJoint : public QObject
 
 public:
     explicit Box2DJoint(QObject *parent = 0);
+    ~Box2DJoint();
 
     bool collideConnected() const;
     void setCollideConnected(bool collideConnected);
@@ -66,7 +68,17 @@ public:
 
 protected:
     virtual void createJoint() = 0;
+
+    /**
+     * Applies the parameters of the definition that can change after the
+     * b2Joint was created, such as limits and motor. Called by the world
+     * once no step is running, see updateJoint().
+     */
+    virtual void updateJointFromDef() {}
+
     b2World *world() const;
+    void destroyJoint(b2World *world, b2Joint *joint);
+    void updateJoint();
 
 
 private slots:
@@ -84,7 +96,10 @@ protected:
     bool mInitializePending;
 
 private:
+    friend class Box2DCoreWorld;
+
     Box2DWorld *mWorld;
+    Box2DCoreWorld *mCoreWorld;
     bool mCollideConnected;
     Box2DBody *mBodyA;
     Box2DBody *mBodyB;
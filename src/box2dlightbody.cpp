@@ -0,0 +1,500 @@
+/*
+ * box2dlightbody.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dlightbody.h"
+
+#include "box2dlightfixture.h"
+#include "box2dworld.h"
+#include "box2dcoreworld.h"
+
+/*!
+    \qmltype LightBody
+    \instantiates Box2DLightBody
+    \inqmlmodule Box2D 1.1
+    \brief A body that is not an item, for colliders that are never drawn.
+
+A LightBody is a plain object instead of an item, so it is much cheaper to
+create and the world does not update it after each step. Its fixtures are
+\l {LightFixture}{light fixtures}, which are not items either. Use it for the walls, triggers and ballast that
+make up most of a level and are never shown.
+
+Its x, y and rotation are read from the simulation on demand and do not
+notify the changes made by the steps. LightBody can not be connected by
+joints.
+
+\code
+LightBody {
+    world: myWorld
+    x: 100; y: 400
+    LightBox { width: 800; height: 20 }
+}
+\endcode
+*/
+
+Box2DLightBody::Box2DLightBody(QObject *parent) :
+    QObject(parent),
+    mWorld(0),
+    mCoreWorld(0),
+    mBody(0),
+    mBodyDef(),
+    mGravityScale(1.0),
+    mTransformPending(false),
+    mComponentComplete(false)
+{
+}
+
+Box2DLightBody::~Box2DLightBody()
+{
+    cleanup();
+}
+
+/*!
+\qmlproperty QtObject LightBody::world
+The \l World or \l CoreWorld the body is simulated in. Defaults to the
+World the body is declared in.
+*/
+void Box2DLightBody::setWorld(QObject *world)
+{
+    if (mWorld == world)
+        return;
+
+    if (world && !qobject_cast<Box2DWorld*>(world)
+            && !qobject_cast<Box2DCoreWorld*>(world)) {
+        qWarning() << "LightBody: world must be a World or a CoreWorld";
+        return;
+    }
+
+    cleanup();
+    mWorld = world;
+    emit worldChanged();
+
+    if (mComponentComplete)
+        initialize();
+}
+
+/*!
+\qmlproperty real LightBody::x
+\qmlproperty real LightBody::y
+The position of the body in the world, in pixels.
+*/
+qreal Box2DLightBody::x() const
+{
+    const b2Body *body = readableBody();
+    if (body && !mTransformPending)
+        return body->GetPosition().x * scaleRatio;
+    return mBodyDef.position.x * scaleRatio;
+}
+
+void Box2DLightBody::setX(qreal x)
+{
+    if (this->x() == x)
+        return;
+
+    setTransform(b2Vec2(x / scaleRatio, -y() / scaleRatio),
+                 (rotation() * b2_pi) / -180.0);
+    emit xChanged();
+}
+
+qreal Box2DLightBody::y() const
+{
+    const b2Body *body = readableBody();
+    if (body && !mTransformPending)
+        return -body->GetPosition().y * scaleRatio;
+    return -mBodyDef.position.y * scaleRatio;
+}
+
+void Box2DLightBody::setY(qreal y)
+{
+    if (this->y() == y)
+        return;
+
+    setTransform(b2Vec2(x() / scaleRatio, -y / scaleRatio),
+                 (rotation() * b2_pi) / -180.0);
+    emit yChanged();
+}
+
+/*!
+\qmlproperty real LightBody::rotation
+The rotation of the body in degrees, clockwise.
+*/
+qreal Box2DLightBody::rotation() const
+{
+    const b2Body *body = readableBody();
+    if (body && !mTransformPending)
+        return (body->GetAngle() * -180.0) / b2_pi;
+    return (mBodyDef.angle * -180.0) / b2_pi;
+}
+
+void Box2DLightBody::setRotation(qreal rotation)
+{
+    if (this->rotation() == rotation)
+        return;
+
+    setTransform(b2Vec2(x() / scaleRatio, -y() / scaleRatio),
+                 (rotation * b2_pi) / -180.0);
+    emit rotationChanged();
+}
+
+/**
+ * Moves the body. While the change has to wait for a step to finish, the
+ * requested transform is what x, y and rotation return.
+ */
+void Box2DLightBody::setTransform(const b2Vec2 &position, float32 angle)
+{
+    mBodyDef.position = position;
+    mBodyDef.angle = angle;
+
+    if (mBody) {
+        mTransformPending = true;
+        mCoreWorld->setBodyTransform(this, position, angle);
+        mCoreWorld->wakeUp();
+    }
+}
+
+/**
+ * Returns the b2Body for reading its state on the GUI thread, after waiting
+ * for a step that is running on the physics thread, see World::threaded.
+ */
+const b2Body *Box2DLightBody::readableBody() const
+{
+    if (mBody && mCoreWorld->isStepPending())
+        mCoreWorld->waitForStep();
+    return mBody;
+}
+
+/*!
+\qmlproperty enum LightBody::bodyType
+Body.Static, Body.Kinematic or Body.Dynamic. See \l Body::bodyType.
+*/
+Box2DBody::BodyType Box2DLightBody::bodyType() const
+{
+    return static_cast<Box2DBody::BodyType>(mBodyDef.type);
+}
+
+void Box2DLightBody::setBodyType(Box2DBody::BodyType bodyType)
+{
+    if (this->bodyType() == bodyType)
+        return;
+
+    mBodyDef.type = static_cast<b2BodyType>(bodyType);
+    if (mBody) {
+        mCoreWorld->updateBody(this);
+        mCoreWorld->wakeUp();
+    }
+
+    emit bodyTypeChanged();
+}
+
+qreal Box2DLightBody::linearDamping() const
+{
+    return mBodyDef.linearDamping;
+}
+
+void Box2DLightBody::setLinearDamping(qreal linearDamping)
+{
+    if (this->linearDamping() == linearDamping)
+        return;
+
+    mBodyDef.linearDamping = linearDamping;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit linearDampingChanged();
+}
+
+qreal Box2DLightBody::angularDamping() const
+{
+    return mBodyDef.angularDamping;
+}
+
+void Box2DLightBody::setAngularDamping(qreal angularDamping)
+{
+    if (this->angularDamping() == angularDamping)
+        return;
+
+    mBodyDef.angularDamping = angularDamping;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit angularDampingChanged();
+}
+
+qreal Box2DLightBody::gravityScale() const
+{
+    return mGravityScale;
+}
+
+void Box2DLightBody::setGravityScale(qreal gravityScale)
+{
+    if (this->gravityScale() == gravityScale)
+        return;
+
+    mGravityScale = gravityScale;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit gravityScaleChanged();
+}
+
+bool Box2DLightBody::fixedRotation() const
+{
+    return mBodyDef.fixedRotation;
+}
+
+void Box2DLightBody::setFixedRotation(bool fixedRotation)
+{
+    if (this->fixedRotation() == fixedRotation)
+        return;
+
+    mBodyDef.fixedRotation = fixedRotation;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit fixedRotationChanged();
+}
+
+bool Box2DLightBody::isBullet() const
+{
+    return mBodyDef.bullet;
+}
+
+void Box2DLightBody::setBullet(bool bullet)
+{
+    if (isBullet() == bullet)
+        return;
+
+    mBodyDef.bullet = bullet;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit bulletChanged();
+}
+
+bool Box2DLightBody::sleepingAllowed() const
+{
+    return mBodyDef.allowSleep;
+}
+
+void Box2DLightBody::setSleepingAllowed(bool allowed)
+{
+    if (sleepingAllowed() == allowed)
+        return;
+
+    mBodyDef.allowSleep = allowed;
+    if (mBody)
+        mCoreWorld->updateBody(this);
+
+    emit sleepingAllowedChanged();
+}
+
+/*!
+\qmlproperty point LightBody::linearVelocity
+The velocity of the body in pixels per second. Changes made by the
+simulation are not notified.
+*/
+QPointF Box2DLightBody::linearVelocity() const
+{
+    const b2Body *body = readableBody();
+    const b2Vec2 &velocity = body ? body->GetLinearVelocity()
+                                  : mBodyDef.linearVelocity;
+    return QPointF(velocity.x * scaleRatio, -velocity.y * scaleRatio);
+}
+
+void Box2DLightBody::setLinearVelocity(const QPointF &linearVelocity)
+{
+    const b2Vec2 velocity(linearVelocity.x() / scaleRatio,
+                          -linearVelocity.y() / scaleRatio);
+
+    mBodyDef.linearVelocity = velocity;
+    if (mBody) {
+        mCoreWorld->setBodyLinearVelocity(this, velocity);
+        mCoreWorld->wakeUp();
+    }
+}
+
+/*!
+\qmlproperty list<LightFixture> LightBody::lightFixtures
+The fixtures of the body, see \l LightFixture. This is the default
+property.
+*/
+QQmlListProperty<Box2DLightFixture> Box2DLightBody::lightFixtures()
+{
+    return QQmlListProperty<Box2DLightFixture>(this, 0,
+                                               &Box2DLightBody::append_light_fixture,
+                                               &Box2DLightBody::count_light_fixture,
+                                               &Box2DLightBody::at_light_fixture,
+                                               0);
+}
+
+void Box2DLightBody::append_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                          Box2DLightFixture *fixture)
+{
+    Box2DLightBody *body = static_cast<Box2DLightBody*>(list->object);
+    fixture->setParent(body);
+    body->mLightFixtures.append(fixture);
+}
+
+int Box2DLightBody::count_light_fixture(QQmlListProperty<Box2DLightFixture> *list)
+{
+    Box2DLightBody *body = static_cast<Box2DLightBody*>(list->object);
+    return body->mLightFixtures.length();
+}
+
+Box2DLightFixture *Box2DLightBody::at_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                                    int index)
+{
+    Box2DLightBody *body = static_cast<Box2DLightBody*>(list->object);
+    if (index < 0 || index >= body->mLightFixtures.length())
+        return NULL;
+    return body->mLightFixtures.at(index);
+}
+
+/*!
+\qmlmethod LightBody::applyForce(force, point)
+\qmlmethod LightBody::applyLinearImpulse(impulse, point)
+Same as the methods of \l Body.
+*/
+void Box2DLightBody::applyForce(const QPointF &force, const QPointF &point)
+{
+    if (mBody) {
+        mCoreWorld->applyForce(this,
+                               b2Vec2(force.x() / scaleRatio,
+                                      -force.y() / scaleRatio),
+                               b2Vec2(point.x() / scaleRatio,
+                                      -point.y() / scaleRatio));
+        mCoreWorld->wakeUp();
+    }
+}
+
+void Box2DLightBody::applyLinearImpulse(const QPointF &impulse,
+                                        const QPointF &point)
+{
+    if (mBody) {
+        mCoreWorld->applyLinearImpulse(this,
+                                       b2Vec2(impulse.x() / scaleRatio,
+                                              -impulse.y() / scaleRatio),
+                                       b2Vec2(point.x() / scaleRatio,
+                                              -point.y() / scaleRatio));
+        mCoreWorld->wakeUp();
+    }
+}
+
+void Box2DLightBody::classBegin()
+{
+}
+
+void Box2DLightBody::componentComplete()
+{
+    mComponentComplete = true;
+
+    // A body declared inside of a World belongs to it
+    if (!mWorld)
+        mWorld = qobject_cast<Box2DWorld*>(parent());
+
+    initialize();
+}
+
+/**
+ * Asks the world to create the b2Body, or waits for the world to create its
+ * b2World first.
+ */
+void Box2DLightBody::initialize()
+{
+    if (!mWorld || mBody)
+        return;
+
+    if (Box2DWorld *world = qobject_cast<Box2DWorld*>(mWorld))
+        mCoreWorld = world->core();
+    else
+        mCoreWorld = static_cast<Box2DCoreWorld*>(mWorld);
+    connect(mCoreWorld, SIGNAL(destroyed()), this, SLOT(worldDestroyed()),
+            Qt::UniqueConnection);
+
+    if (!mCoreWorld->world()) {
+        connect(mCoreWorld, SIGNAL(initialized()), this, SLOT(initialize()),
+                Qt::UniqueConnection);
+        return;
+    }
+
+    mCoreWorld->createBody(this);
+}
+
+/**
+ * Creates the b2Body and its fixtures. Called by the world once no step is
+ * running. The b2Body has no user data, which keeps it out of the bodies
+ * the world synchronizes after each step.
+ */
+void Box2DLightBody::createBody()
+{
+    mBody = mCoreWorld->world()->CreateBody(&mBodyDef);
+    if (mGravityScale != 1.0)
+        mBody->SetGravityScale(mGravityScale);
+    foreach (Box2DLightFixture *fixture, mLightFixtures)
+        fixture->createFixture(mBody);
+    mTransformPending = false;
+    emit bodyCreated();
+}
+
+/**
+ * Destroys the b2Body, keeping its state in the body definition in case the
+ * body is given another world.
+ */
+void Box2DLightBody::cleanup()
+{
+    if (!mCoreWorld)
+        return;
+
+    mCoreWorld->cancelCommands(this);
+    disconnect(mCoreWorld, 0, this, 0);
+
+    if (mBody) {
+        if (!mTransformPending) {
+            mBodyDef.position = mBody->GetPosition();
+            mBodyDef.angle = mBody->GetAngle();
+        }
+        mBodyDef.linearVelocity = mBody->GetLinearVelocity();
+        mBodyDef.angularVelocity = mBody->GetAngularVelocity();
+        mBodyDef.awake = mBody->IsAwake();
+        mCoreWorld->destroyBody(mBody);
+    }
+
+    foreach (Box2DLightFixture *fixture, mLightFixtures)
+        fixture->resetFixture();
+    mBody = 0;
+    mCoreWorld = 0;
+    mTransformPending = false;
+}
+
+/**
+ * The b2Body was deleted along with the b2World.
+ */
+void Box2DLightBody::worldDestroyed()
+{
+    foreach (Box2DLightFixture *fixture, mLightFixtures)
+        fixture->resetFixture();
+    mBody = 0;
+    mCoreWorld = 0;
+    mWorld = 0;
+    mTransformPending = false;
+}
@@ -0,0 +1,161 @@
+/*
+ * box2dlightbody.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DLIGHTBODY_H
+#define BOX2DLIGHTBODY_H
+
+#include <QObject>
+#include <QPointF>
+#include <QQmlParserStatus>
+#include <QQmlListProperty>
+#include <Box2D.h>
+
+#include "box2dbody.h"
+
+class Box2DLightFixture;
+class Box2DCoreWorld;
+
+/**
+ * A body without an item, for colliders that are never drawn: walls,
+ * triggers, ballast. Its position is only read from the b2Body on demand,
+ * so the world does not update it after each step.
+ */
+class Box2DLightBody : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY(QObject *world READ world WRITE setWorld NOTIFY worldChanged)
+    Q_PROPERTY(qreal x READ x WRITE setX NOTIFY xChanged)
+    Q_PROPERTY(qreal y READ y WRITE setY NOTIFY yChanged)
+    Q_PROPERTY(qreal rotation READ rotation WRITE setRotation NOTIFY rotationChanged)
+    Q_PROPERTY(Box2DBody::BodyType bodyType READ bodyType WRITE setBodyType NOTIFY bodyTypeChanged)
+    Q_PROPERTY(qreal linearDamping READ linearDamping WRITE setLinearDamping NOTIFY linearDampingChanged)
+    Q_PROPERTY(qreal angularDamping READ angularDamping WRITE setAngularDamping NOTIFY angularDampingChanged)
+    Q_PROPERTY(qreal gravityScale READ gravityScale WRITE setGravityScale NOTIFY gravityScaleChanged)
+    Q_PROPERTY(bool fixedRotation READ fixedRotation WRITE setFixedRotation NOTIFY fixedRotationChanged)
+    Q_PROPERTY(bool bullet READ isBullet WRITE setBullet NOTIFY bulletChanged)
+    Q_PROPERTY(bool sleepingAllowed READ sleepingAllowed WRITE setSleepingAllowed NOTIFY sleepingAllowedChanged)
+    Q_PROPERTY(QPointF linearVelocity READ linearVelocity WRITE setLinearVelocity)
+    Q_PROPERTY(QQmlListProperty<Box2DLightFixture> lightFixtures READ lightFixtures)
+    Q_CLASSINFO("DefaultProperty", "lightFixtures")
+
+public:
+    explicit Box2DLightBody(QObject *parent = 0);
+    ~Box2DLightBody();
+
+    /**
+     * The World or CoreWorld the body is simulated in.
+     */
+    QObject *world() const { return mWorld; }
+    void setWorld(QObject *world);
+
+    qreal x() const;
+    void setX(qreal x);
+
+    qreal y() const;
+    void setY(qreal y);
+
+    qreal rotation() const;
+    void setRotation(qreal rotation);
+
+    Box2DBody::BodyType bodyType() const;
+    void setBodyType(Box2DBody::BodyType bodyType);
+
+    qreal linearDamping() const;
+    void setLinearDamping(qreal linearDamping);
+
+    qreal angularDamping() const;
+    void setAngularDamping(qreal angularDamping);
+
+    qreal gravityScale() const;
+    void setGravityScale(qreal gravityScale);
+
+    bool fixedRotation() const;
+    void setFixedRotation(bool fixedRotation);
+
+    bool isBullet() const;
+    void setBullet(bool bullet);
+
+    bool sleepingAllowed() const;
+    void setSleepingAllowed(bool allowed);
+
+    QPointF linearVelocity() const;
+    void setLinearVelocity(const QPointF &linearVelocity);
+
+    QQmlListProperty<Box2DLightFixture> lightFixtures();
+
+    Q_INVOKABLE void applyForce(const QPointF &force, const QPointF &point);
+    Q_INVOKABLE void applyLinearImpulse(const QPointF &impulse,
+                                        const QPointF &point);
+
+    void classBegin();
+    void componentComplete();
+
+    b2Body *body() const { return mBody; }
+    Box2DCoreWorld *coreWorld() const { return mCoreWorld; }
+
+signals:
+    void worldChanged();
+    void xChanged();
+    void yChanged();
+    void rotationChanged();
+    void bodyTypeChanged();
+    void linearDampingChanged();
+    void angularDampingChanged();
+    void gravityScaleChanged();
+    void fixedRotationChanged();
+    void bulletChanged();
+    void sleepingAllowedChanged();
+    void bodyCreated();
+
+private slots:
+    void initialize();
+    void worldDestroyed();
+
+private:
+    friend class Box2DCoreWorld;
+
+    void createBody();
+    void cleanup();
+    void setTransform(const b2Vec2 &position, float32 angle);
+    const b2Body *readableBody() const;
+
+    static void append_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                     Box2DLightFixture *fixture);
+    static int count_light_fixture(QQmlListProperty<Box2DLightFixture> *list);
+    static Box2DLightFixture *at_light_fixture(QQmlListProperty<Box2DLightFixture> *list,
+                                               int index);
+
+    QObject *mWorld;
+    Box2DCoreWorld *mCoreWorld;
+    b2Body *mBody;
+    b2BodyDef mBodyDef;
+    qreal mGravityScale;
+    bool mTransformPending;
+    bool mComponentComplete;
+    QList<Box2DLightFixture*> mLightFixtures;
+};
+
+#endif // BOX2DLIGHTBODY_H
@@ -0,0 +1,342 @@
+/*
+ * box2dlightfixture.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dlightfixture.h"
+
+#include "box2dcoreworld.h"
+#include "box2dbody.h"
+#include "box2dlightbody.h"
+
+#include <QDebug>
+
+/*!
+    \qmltype LightFixture
+    \instantiates Box2DLightFixture
+    \inqmlmodule Box2D 1.1
+    \brief A fixture that is not an item. Use a LightBox, LightCircle,
+    LightPolygon or LightChain.
+
+Light fixtures have the material and filtering properties of \l Fixture,
+but they are plain objects instead of items. They are much cheaper to
+create and do not add to the items of their body. Their shape is only read
+when the body is created, so they do not follow changes of their size, and
+they do not emit contact signals. Use them for the parts of a body that
+never resize and do not need to report contacts, like the limbs of a
+ragdoll.
+
+Light fixtures are added to the lightFixtures of a \l Body or
+\l LightBody.
+
+\code
+Body {
+    lightFixtures: [
+        LightBox { width: 20; height: 60; density: 1 },
+        LightCircle { y: -20; radius: 10; density: 1 }
+    ]
+}
+\endcode
+*/
+
+Box2DLightFixture::Box2DLightFixture(QObject *parent) :
+    QObject(parent),
+    mFixture(0),
+    mFixtureDef(),
+    mDirty(false)
+{
+}
+
+void Box2DLightFixture::setDensity(float density)
+{
+    if (mFixtureDef.density == density)
+        return;
+
+    mFixtureDef.density = density;
+    mDirty = true;
+    if (mFixture)
+        updateFixture();
+    emit densityChanged();
+}
+
+void Box2DLightFixture::setFriction(float friction)
+{
+    if (mFixtureDef.friction == friction)
+        return;
+
+    mFixtureDef.friction = friction;
+    mDirty = true;
+    if (mFixture)
+        updateFixture();
+    emit frictionChanged();
+}
+
+void Box2DLightFixture::setRestitution(float restitution)
+{
+    if (mFixtureDef.restitution == restitution)
+        return;
+
+    mFixtureDef.restitution = restitution;
+    mDirty = true;
+    if (mFixture)
+        updateFixture();
+    emit restitutionChanged();
+}
+
+Box2DFixture::CategoryFlags Box2DLightFixture::categories() const
+{
+    return Box2DFixture::CategoryFlags(mFixtureDef.filter.categoryBits);
+}
+
+void Box2DLightFixture::setCategories(Box2DFixture::CategoryFlags layers)
+{
+    if (mFixtureDef.filter.categoryBits == layers)
+        return;
+
+    mFixtureDef.filter.categoryBits = layers;
+    mDirty = true;
+    emit categoriesChanged();
+}
+
+Box2DFixture::CategoryFlags Box2DLightFixture::collidesWith() const
+{
+    return Box2DFixture::CategoryFlags(mFixtureDef.filter.maskBits);
+}
+
+void Box2DLightFixture::setCollidesWith(Box2DFixture::CategoryFlags layers)
+{
+    if (mFixtureDef.filter.maskBits == layers)
+        return;
+
+    mFixtureDef.filter.maskBits = layers;
+    mDirty = true;
+    emit collidesWithChanged();
+}
+
+void Box2DLightFixture::setGroupIndex(int groupIndex)
+{
+    if (mFixtureDef.filter.groupIndex == groupIndex)
+        return;
+
+    mFixtureDef.filter.groupIndex = groupIndex;
+    mDirty = true;
+    emit groupIndexChanged();
+}
+
+/**
+ * Passes a change of the definition on to the b2Fixture through the world of
+ * the body, which defers it while a step is running. The body is either a
+ * Body or a LightBody.
+ */
+void Box2DLightFixture::updateFixture()
+{
+    Box2DCoreWorld *world = 0;
+    if (Box2DBody *body = qobject_cast<Box2DBody*>(parent()))
+        world = body->coreWorld();
+    else if (Box2DLightBody *body = qobject_cast<Box2DLightBody*>(parent()))
+        world = body->coreWorld();
+
+    if (world)
+        world->updateFixture(this);
+}
+
+/**
+ * Creates the b2Fixture on the given body. It has no user data, so the
+ * world does not report its contacts.
+ */
+void Box2DLightFixture::createFixture(b2Body *body)
+{
+    b2Shape *shape = createShape();
+    if (!shape)
+        return;
+
+    mFixtureDef.shape = shape;
+    mFixture = body->CreateFixture(&mFixtureDef);
+    mFixtureDef.shape = 0;
+    delete shape;
+}
+
+/**
+ * Like createShape(), but a polygon is returned without its convex hull,
+ * see Box2DFixture::createDeferredShape(). Other shapes leave hull empty.
+ */
+b2Shape *Box2DLightFixture::createDeferredShape(QVector<b2Vec2> *hull)
+{
+    Q_UNUSED(hull);
+    return createShape();
+}
+
+/**
+ * Converts a list of points in pixels to vertices in meters. Returns 0 and
+ * warns when two vertices are too close together.
+ */
+static b2Vec2 *toVertices(const QVariantList &points, const char *type)
+{
+    const int count = points.length();
+    b2Vec2 *vertices = new b2Vec2[count];
+    for (int i = 0; i < count; ++i) {
+        const QPointF &point = points.at(i).toPointF();
+        vertices[i].Set(point.x() / scaleRatio, -point.y() / scaleRatio);
+        if (i > 0 && b2DistanceSquared(vertices[i - 1], vertices[i])
+                <= b2_linearSlop * b2_linearSlop) {
+            qWarning() << type << "vertices are too close together";
+            delete[] vertices;
+            return 0;
+        }
+    }
+    return vertices;
+}
+
+/*!
+    \qmltype LightBox
+    \instantiates Box2DLightBox
+    \inqmlmodule Box2D 1.1
+    \inherits LightFixture
+    \brief A box that is not an item.
+
+\qmlproperty real LightBox::x
+\qmlproperty real LightBox::y
+\qmlproperty real LightBox::width
+\qmlproperty real LightBox::height
+The rectangle of the box relative to its body, in pixels.
+*/
+b2Shape *Box2DLightBox::createShape()
+{
+    const qreal x = mX / scaleRatio;
+    const qreal y = -mY / scaleRatio;
+    const qreal width = mWidth / scaleRatio;
+    const qreal height = mHeight / scaleRatio;
+
+    if (width <= b2_linearSlop || height <= b2_linearSlop) {
+        qWarning() << "LightBox: vertices are too close together";
+        return 0;
+    }
+
+    b2Vec2 vertices[4];
+    vertices[0].Set(x, y);
+    vertices[1].Set(x, y - height);
+    vertices[2].Set(x + width, y - height);
+    vertices[3].Set(x + width, y);
+
+    b2PolygonShape *shape = new b2PolygonShape;
+    shape->Set(vertices, 4);
+    return shape;
+}
+
+/*!
+    \qmltype LightCircle
+    \instantiates Box2DLightCircle
+    \inqmlmodule Box2D 1.1
+    \inherits LightFixture
+    \brief A circle that is not an item.
+
+\qmlproperty real LightCircle::x
+\qmlproperty real LightCircle::y
+The top-left corner of the bounding square of the circle relative to its
+body, in pixels, as with \l Circle.
+
+\qmlproperty real LightCircle::radius
+The radius of the circle in pixels.
+*/
+b2Shape *Box2DLightCircle::createShape()
+{
+    b2CircleShape *shape = new b2CircleShape;
+    shape->m_radius = mRadius / scaleRatio;
+    shape->m_p.Set((mX + mRadius) / scaleRatio, -(mY + mRadius) / scaleRatio);
+    return shape;
+}
+
+/*!
+    \qmltype LightPolygon
+    \instantiates Box2DLightPolygon
+    \inqmlmodule Box2D 1.1
+    \inherits LightFixture
+    \brief A convex polygon that is not an item.
+
+\qmlproperty list<point> LightPolygon::vertices
+The vertices of the polygon relative to its body, in pixels.
+*/
+b2Shape *Box2DLightPolygon::createShape()
+{
+    QVector<b2Vec2> hull;
+    b2PolygonShape *shape = static_cast<b2PolygonShape*>(createDeferredShape(&hull));
+    if (shape)
+        shape->Set(hull.constData(), hull.count());
+    return shape;
+}
+
+/**
+ * Checks the vertices and returns an empty polygon, leaving the computation
+ * of its convex hull from the vertices to the caller.
+ */
+b2Shape *Box2DLightPolygon::createDeferredShape(QVector<b2Vec2> *hull)
+{
+    const int count = mVertices.length();
+    if (count < 3 || count > b2_maxPolygonVertices) {
+        qWarning() << "LightPolygon: Invalid number of vertices:" << count;
+        return 0;
+    }
+
+    b2Vec2 *vertices = toVertices(mVertices, "LightPolygon:");
+    if (!vertices)
+        return 0;
+
+    hull->resize(count);
+    for (int i = 0; i < count; ++i)
+        (*hull)[i] = vertices[i];
+    delete[] vertices;
+    return new b2PolygonShape;
+}
+
+/*!
+    \qmltype LightChain
+    \instantiates Box2DLightChain
+    \inqmlmodule Box2D 1.1
+    \inherits LightFixture
+    \brief A chain of edges that is not an item, for static level geometry.
+
+\qmlproperty list<point> LightChain::vertices
+The vertices of the chain relative to its body, in pixels.
+
+\qmlproperty bool LightChain::loop
+Whether the last vertex is connected to the first one.
+*/
+b2Shape *Box2DLightChain::createShape()
+{
+    const int count = mVertices.length();
+    if (count < 2) {
+        qWarning() << "LightChain: Invalid number of vertices:" << count;
+        return 0;
+    }
+
+    b2Vec2 *vertices = toVertices(mVertices, "LightChain:");
+    if (!vertices)
+        return 0;
+
+    b2ChainShape *shape = new b2ChainShape;
+    if (mLoop)
+        shape->CreateLoop(vertices, count);
+    else
+        shape->CreateChain(vertices, count);
+    delete[] vertices;
+    return shape;
+}
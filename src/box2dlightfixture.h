@@ -0,0 +1,229 @@
+/*
+ * box2dlightfixture.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DLIGHTFIXTURE_H
+#define BOX2DLIGHTFIXTURE_H
+
+#include <QObject>
+#include <QPointF>
+#include <QVariant>
+#include <QVector>
+#include <Box2D.h>
+
+#include "box2dfixture.h"
+
+class b2Body;
+class b2Fixture;
+class b2Shape;
+
+/**
+ * A fixture that is not an item. It holds a b2FixtureDef and the parameters
+ * of its shape, which are only read when the b2Fixture is created, so it
+ * does not follow changes of its size.
+ */
+class Box2DLightFixture : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(float density READ density WRITE setDensity NOTIFY densityChanged)
+    Q_PROPERTY(float friction READ friction WRITE setFriction NOTIFY frictionChanged)
+    Q_PROPERTY(float restitution READ restitution WRITE setRestitution NOTIFY restitutionChanged)
+    Q_PROPERTY(Box2DFixture::CategoryFlags categories READ categories WRITE setCategories NOTIFY categoriesChanged)
+    Q_PROPERTY(Box2DFixture::CategoryFlags collidesWith READ collidesWith WRITE setCollidesWith NOTIFY collidesWithChanged)
+    Q_PROPERTY(int groupIndex READ groupIndex WRITE setGroupIndex NOTIFY groupIndexChanged)
+
+public:
+    explicit Box2DLightFixture(QObject *parent = 0);
+
+    float density() const { return mFixtureDef.density; }
+    void setDensity(float density);
+
+    float friction() const { return mFixtureDef.friction; }
+    void setFriction(float friction);
+
+    float restitution() const { return mFixtureDef.restitution; }
+    void setRestitution(float restitution);
+
+    Box2DFixture::CategoryFlags categories() const;
+    void setCategories(Box2DFixture::CategoryFlags layers);
+
+    Box2DFixture::CategoryFlags collidesWith() const;
+    void setCollidesWith(Box2DFixture::CategoryFlags layers);
+
+    int groupIndex() const { return mFixtureDef.filter.groupIndex; }
+    void setGroupIndex(int groupIndex);
+
+    void createFixture(b2Body *body);
+
+    /**
+     * Forgets the b2Fixture, which was destroyed along with its body.
+     */
+    void resetFixture() { mFixture = 0; }
+
+    b2Fixture *fixture() const { return mFixture; }
+
+signals:
+    void densityChanged();
+    void frictionChanged();
+    void restitutionChanged();
+    void categoriesChanged();
+    void collidesWithChanged();
+    void groupIndexChanged();
+
+protected:
+    friend class Box2DCoreWorld;
+
+    virtual b2Shape *createShape() = 0;
+    virtual b2Shape *createDeferredShape(QVector<b2Vec2> *hull);
+    void updateFixture();
+
+    b2Fixture *mFixture;
+    b2FixtureDef mFixtureDef;
+
+    /**
+     * Whether the definition or the shape changed since an asynchronous
+     * world collected them, in which case it recreates the b2Fixture.
+     */
+    bool mDirty;
+};
+
+class Box2DLightBox : public Box2DLightFixture
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qreal x READ x WRITE setX)
+    Q_PROPERTY(qreal y READ y WRITE setY)
+    Q_PROPERTY(qreal width READ width WRITE setWidth)
+    Q_PROPERTY(qreal height READ height WRITE setHeight)
+
+public:
+    explicit Box2DLightBox(QObject *parent = 0) :
+        Box2DLightFixture(parent),
+        mX(0), mY(0), mWidth(0), mHeight(0)
+    { }
+
+    qreal x() const { return mX; }
+    void setX(qreal x) { mX = x; mDirty = true; }
+
+    qreal y() const { return mY; }
+    void setY(qreal y) { mY = y; mDirty = true; }
+
+    qreal width() const { return mWidth; }
+    void setWidth(qreal width) { mWidth = width; mDirty = true; }
+
+    qreal height() const { return mHeight; }
+    void setHeight(qreal height) { mHeight = height; mDirty = true; }
+
+protected:
+    b2Shape *createShape();
+
+private:
+    qreal mX;
+    qreal mY;
+    qreal mWidth;
+    qreal mHeight;
+};
+
+class Box2DLightCircle : public Box2DLightFixture
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qreal x READ x WRITE setX)
+    Q_PROPERTY(qreal y READ y WRITE setY)
+    Q_PROPERTY(float radius READ radius WRITE setRadius)
+
+public:
+    explicit Box2DLightCircle(QObject *parent = 0) :
+        Box2DLightFixture(parent),
+        mX(0), mY(0), mRadius(0)
+    { }
+
+    qreal x() const { return mX; }
+    void setX(qreal x) { mX = x; mDirty = true; }
+
+    qreal y() const { return mY; }
+    void setY(qreal y) { mY = y; mDirty = true; }
+
+    float radius() const { return mRadius; }
+    void setRadius(float radius) { mRadius = radius; mDirty = true; }
+
+protected:
+    b2Shape *createShape();
+
+private:
+    qreal mX;
+    qreal mY;
+    float mRadius;
+};
+
+class Box2DLightPolygon : public Box2DLightFixture
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QVariantList vertices READ vertices WRITE setVertices)
+
+public:
+    explicit Box2DLightPolygon(QObject *parent = 0) :
+        Box2DLightFixture(parent)
+    { }
+
+    QVariantList vertices() const { return mVertices; }
+    void setVertices(const QVariantList &vertices) { mVertices = vertices; mDirty = true; }
+
+protected:
+    b2Shape *createShape();
+    b2Shape *createDeferredShape(QVector<b2Vec2> *hull);
+
+private:
+    QVariantList mVertices;
+};
+
+class Box2DLightChain : public Box2DLightFixture
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QVariantList vertices READ vertices WRITE setVertices)
+    Q_PROPERTY(bool loop READ loop WRITE setLoop)
+
+public:
+    explicit Box2DLightChain(QObject *parent = 0) :
+        Box2DLightFixture(parent),
+        mLoop(false)
+    { }
+
+    QVariantList vertices() const { return mVertices; }
+    void setVertices(const QVariantList &vertices) { mVertices = vertices; mDirty = true; }
+
+    bool loop() const { return mLoop; }
+    void setLoop(bool loop) { mLoop = loop; mDirty = true; }
+
+protected:
+    b2Shape *createShape();
+
+private:
+    QVariantList mVertices;
+    bool mLoop;
+};
+
+#endif // BOX2DLIGHTFIXTURE_H
@@ -78,8 +78,7 @@ void Box2DMotorJoint::setLinearOffset(const QPointF &linearOffset)
     if(this->linearOffset() == linearOffset)
         return;
     mMotorJointDef.linearOffset = b2Vec2(linearOffset.x() / scaleRatio,-linearOffset.y() / scaleRatio);
-    if(mMotorJoint)
-        mMotorJoint->SetLinearOffset(mMotorJointDef.linearOffset);
+    updateJoint();
     emit linearOffsetChanged();
 }
 
@@ -99,8 +98,7 @@ void Box2DMotorJoint::setAngularOffset(const float angularOffset)
     if(mMotorJointDef.angularOffset == angularOffsetRad)
         return;
     mMotorJointDef.angularOffset = angularOffsetRad;
-    if(mMotorJoint)
-        mMotorJoint->SetAngularOffset(angularOffsetRad);
+    updateJoint();
     emit angularOffsetChanged();
 }
 
@@ -118,8 +116,7 @@ void Box2DMotorJoint::setMaxForce(const float maxForce)
     if(mMotorJointDef.maxForce == maxForce)
         return;
     mMotorJointDef.maxForce = maxForce;
-    if(mMotorJoint)
-        mMotorJoint->SetMaxForce(maxForce);
+    updateJoint();
     emit maxForceChanged();
 }
 
@@ -137,8 +134,7 @@ void Box2DMotorJoint::setMaxTorque(const float maxTorque)
     if(mMotorJointDef.maxTorque == maxTorque)
         return;
     mMotorJointDef.maxTorque = maxTorque;
-    if(mMotorJoint)
-        mMotorJoint->SetMaxTorque(maxTorque);
+    updateJoint();
     emit maxTorqueChanged();
 }
 
@@ -156,8 +152,7 @@ void Box2DMotorJoint::setCorrectionFactor(const float correctionFactor)
     if(mMotorJointDef.correctionFactor == correctionFactor)
         return;
     mMotorJointDef.correctionFactor = correctionFactor;
-    if(mMotorJoint)
-        mMotorJoint->SetCorrectionFactor(correctionFactor);
+    updateJoint();
     emit correctionFactorChanged();
 }
 
@@ -178,6 +173,15 @@ void Box2DMotorJoint::createJoint()
     emit created();
 }
 
+void Box2DMotorJoint::updateJointFromDef()
+{
+    mMotorJoint->SetLinearOffset(mMotorJointDef.linearOffset);
+    mMotorJoint->SetAngularOffset(mMotorJointDef.angularOffset);
+    mMotorJoint->SetMaxForce(mMotorJointDef.maxForce);
+    mMotorJoint->SetMaxTorque(mMotorJointDef.maxTorque);
+    mMotorJoint->SetCorrectionFactor(mMotorJointDef.correctionFactor);
+}
+
 void Box2DMotorJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -186,7 +190,7 @@ void Box2DMotorJoint::cleanup(b2World *world)
     }
     if (mMotorJoint && bodyA() && bodyB()) {
         mMotorJoint->SetUserData(0);
-        world->DestroyJoint(mMotorJoint);
+        destroyJoint(world, mMotorJoint);
         mMotorJoint = 0;
     }
 }
@@ -25,7 +25,7 @@
 
 #include "box2dmousejoint.h"
 
-#include "box2dworld.h"
+#include "box2dcoreworld.h"
 #include "box2dbody.h"
 
 /*!
@@ -62,15 +62,13 @@ the damping ratio that is allowed to the element.
 */
 float Box2DMouseJoint::dampingRatio() const
 {
-    if(mMouseJoint) return mMouseJoint->GetDampingRatio();
     return mMouseJointDef.dampingRatio;
 }
 
 void Box2DMouseJoint::setDampingRatio(float dampingRatio)
 {
     mMouseJointDef.dampingRatio = dampingRatio;
-    if(mMouseJoint) mMouseJoint->SetDampingRatio(dampingRatio);
-
+    updateJoint();
 }
 
 /*!
@@ -79,14 +77,13 @@ the frequency that one would like to use on the MouseJoint
 */
 float Box2DMouseJoint::frequencyHz() const
 {
-    if(mMouseJoint) return mMouseJoint->GetFrequency();
     return mMouseJointDef.frequencyHz;
 }
 
 void Box2DMouseJoint::setFrequencyHz(float frequencyHz)
 {
     mMouseJointDef.frequencyHz = frequencyHz;
-    if(mMouseJoint) mMouseJoint->SetFrequency(frequencyHz);
+    updateJoint();
 }
 
 /*!
@@ -95,14 +92,13 @@ the maxium ammount of force that is allowed to the MouseJoint
 */
 float Box2DMouseJoint::maxForce() const
 {
-    if(mMouseJoint) return mMouseJoint->GetMaxForce();
     return mMouseJointDef.maxForce;
 }
 
 void Box2DMouseJoint::setMaxForce(float maxForce)
 {
     mMouseJointDef.maxForce = maxForce;
-    if(mMouseJoint) mMouseJoint->SetMaxForce(maxForce);
+    updateJoint();
 }
 
 /*!
@@ -111,17 +107,20 @@ the item in which you want to target, for the MouseJoint
 */
 QPointF Box2DMouseJoint::target() const
 {
-    b2Vec2 point;
-    if(mMouseJoint) point = mMouseJoint->GetTarget();
-    else point = mMouseJointDef.target;
-    return QPointF(point.x * scaleRatio,-point.y * scaleRatio);
+    return QPointF(mMouseJointDef.target.x * scaleRatio,
+                   -mMouseJointDef.target.y * scaleRatio);
 }
 
 void Box2DMouseJoint::setTarget(const QPointF &_target)
 {
     if(_target == target()) return;
     mMouseJointDef.target = b2Vec2(_target.x() / scaleRatio, -_target.y() / scaleRatio);
-    if(mMouseJoint) mMouseJoint->SetTarget(mMouseJointDef.target);
+    if(mMouseJoint) {
+        updateJoint();
+        // Dragging a sleeping body has to resume an idle world
+        if (bodyB()->coreWorld())
+            bodyB()->coreWorld()->wakeUp();
+    }
 }
 
 void Box2DMouseJoint::nullifyJoint()
@@ -141,6 +140,14 @@ void Box2DMouseJoint::createJoint()
     emit created();
 }
 
+void Box2DMouseJoint::updateJointFromDef()
+{
+    mMouseJoint->SetDampingRatio(mMouseJointDef.dampingRatio);
+    mMouseJoint->SetFrequency(mMouseJointDef.frequencyHz);
+    mMouseJoint->SetMaxForce(mMouseJointDef.maxForce);
+    mMouseJoint->SetTarget(mMouseJointDef.target);
+}
+
 void Box2DMouseJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -149,7 +156,7 @@ void Box2DMouseJoint::cleanup(b2World *world)
     }
     if (mMouseJoint && bodyA() && bodyB()) {
         mMouseJoint->SetUserData(0);
-        world->DestroyJoint(mMouseJoint);
+        destroyJoint(world, mMouseJoint);
         mMouseJoint = 0;
     }
 }
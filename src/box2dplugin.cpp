@@ -28,9 +28,16 @@
 #include "box2dplugin.h"
 
 #include "box2dworld.h"
+#include "box2dcoreworld.h"
+#include "box2dworldbatch.h"
+#include "box2dshardedworld.h"
 #include "box2dbody.h"
+#include "box2dlightbody.h"
+#include "box2dbodypool.h"
+#include "box2dbodyinstancer.h"
 #include "box2ddebugdraw.h"
 #include "box2dfixture.h"
+#include "box2dlightfixture.h"
 #include "box2djoint.h"
 
 #include "box2ddistancejoint.h"
@@ -55,7 +62,13 @@ void Box2DPlugin::registerTypes(const char *uri)
 {
     // @uri Box2D
     qmlRegisterType<Box2DWorld>(uri, 1, 1, "World");
+    qmlRegisterType<Box2DCoreWorld>(uri, 1, 1, "CoreWorld");
+    qmlRegisterType<Box2DWorldBatch>(uri, 1, 1, "WorldBatch");
+    qmlRegisterType<Box2DShardedWorld>(uri, 1, 1, "ShardedWorld");
     qmlRegisterType<Box2DBody>(uri, 1, 1, "Body");
+    qmlRegisterType<Box2DLightBody>(uri, 1, 1, "LightBody");
+    qmlRegisterType<Box2DBodyPool>(uri, 1, 1, "BodyPool");
+    qmlRegisterType<Box2DBodyInstancer>(uri, 1, 1, "BodyInstancer");
     qmlRegisterUncreatableType<Box2DFixture>(uri, 1,0, "Fixture",
                                              QStringLiteral("Base type for Box, Circle etc."));
     qmlRegisterType<Box2DBox>(uri, 1, 1, "Box");
@@ -63,6 +76,12 @@ void Box2DPlugin::registerTypes(const char *uri)
     qmlRegisterType<Box2DPolygon>(uri, 1, 1, "Polygon");
     qmlRegisterType<Box2DChain>(uri, 1, 1, "Chain");
     qmlRegisterType<Box2DEdge>(uri, 1, 1, "Edge");
+    qmlRegisterUncreatableType<Box2DLightFixture>(uri, 1, 1, "LightFixture",
+                                                  QStringLiteral("Base type for LightBox, LightCircle, LightPolygon and LightChain"));
+    qmlRegisterType<Box2DLightBox>(uri, 1, 1, "LightBox");
+    qmlRegisterType<Box2DLightCircle>(uri, 1, 1, "LightCircle");
+    qmlRegisterType<Box2DLightPolygon>(uri, 1, 1, "LightPolygon");
+    qmlRegisterType<Box2DLightChain>(uri, 1, 1, "LightChain");
     qmlRegisterType<Box2DDebugDraw>(uri, 1, 1, "DebugDraw");
     qmlRegisterUncreatableType<Box2DJoint>(uri, 1, 1, "Joint",
                                            QStringLiteral("Base type for DistanceJoint, RevoluteJoint etc."));
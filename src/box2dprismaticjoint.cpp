@@ -96,9 +96,7 @@ void Box2DPrismaticJoint::setLowerTranslation(float lowerTranslation)
     if (qFuzzyCompare(mPrismaticJointDef.lowerTranslation,lowerTranslation / scaleRatio))
         return;
     mPrismaticJointDef.lowerTranslation = lowerTranslation / scaleRatio;
-    if (mPrismaticJoint)
-        mPrismaticJoint->SetLimits(mPrismaticJointDef.lowerTranslation,
-                                   mPrismaticJointDef.upperTranslation);
+    updateJoint();
     emit lowerTranslationChanged();
 }
 
@@ -118,9 +116,7 @@ void Box2DPrismaticJoint::setUpperTranslation(float upperTranslation)
         return;
 
     mPrismaticJointDef.upperTranslation = upperTranslation / scaleRatio;
-    if (mPrismaticJoint)
-        mPrismaticJoint->SetLimits(mPrismaticJointDef.lowerTranslation,
-                                   mPrismaticJointDef.upperTranslation);
+    updateJoint();
     emit upperTranslationChanged();
 }
 
@@ -139,8 +135,7 @@ void Box2DPrismaticJoint::setMaxMotorForce(float maxMotorForce)
         return;
 
     mPrismaticJointDef.maxMotorForce = maxMotorForce;
-    if (mPrismaticJoint)
-        mPrismaticJoint->SetMaxMotorForce(maxMotorForce);
+    updateJoint();
     emit maxMotorForceChanged();
 }
 
@@ -159,8 +154,7 @@ void Box2DPrismaticJoint::setMotorSpeed(float motorSpeed)
         return;
 
     mPrismaticJointDef.motorSpeed = motorSpeed / scaleRatio;
-    if (mPrismaticJoint)
-        mPrismaticJoint->SetMotorSpeed(mPrismaticJointDef.motorSpeed);
+    updateJoint();
     emit motorSpeedChanged();
 }
 
@@ -175,8 +169,7 @@ void Box2DPrismaticJoint::setEnableLimit(bool enableLimit)
         return;
 
     mPrismaticJointDef.enableLimit = enableLimit;
-    if (mPrismaticJoint)
-        mPrismaticJoint->EnableLimit(enableLimit);
+    updateJoint();
     emit enableLimitChanged();
 }
 
@@ -195,8 +188,7 @@ void Box2DPrismaticJoint::setEnableMotor(bool enableMotor)
         return;
 
     mPrismaticJointDef.enableMotor = enableMotor;
-    if (mPrismaticJoint)
-        mPrismaticJoint->EnableMotor(enableMotor);
+    updateJoint();
     emit enableMotorChanged();
 }
 
@@ -276,6 +268,16 @@ void Box2DPrismaticJoint::createJoint()
     emit created();
 }
 
+void Box2DPrismaticJoint::updateJointFromDef()
+{
+    mPrismaticJoint->SetLimits(mPrismaticJointDef.lowerTranslation,
+                               mPrismaticJointDef.upperTranslation);
+    mPrismaticJoint->SetMaxMotorForce(mPrismaticJointDef.maxMotorForce);
+    mPrismaticJoint->SetMotorSpeed(mPrismaticJointDef.motorSpeed);
+    mPrismaticJoint->EnableLimit(mPrismaticJointDef.enableLimit);
+    mPrismaticJoint->EnableMotor(mPrismaticJointDef.enableMotor);
+}
+
 void Box2DPrismaticJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -284,7 +286,7 @@ void Box2DPrismaticJoint::cleanup(b2World *world)
     }
     if (mPrismaticJoint && bodyA() && bodyB()) {
         mPrismaticJoint->SetUserData(0);
-        world->DestroyJoint(mPrismaticJoint);
+        destroyJoint(world, mPrismaticJoint);
         mPrismaticJoint = 0;
     }
 }
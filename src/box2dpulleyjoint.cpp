@@ -313,7 +313,7 @@ void Box2DPulleyJoint::cleanup(b2World *world)
     }
     if (mPulleyJoint && bodyA() && bodyB()) {
         mPulleyJoint->SetUserData(0);
-        world->DestroyJoint(mPulleyJoint);
+        destroyJoint(world, mPulleyJoint);
         mPulleyJoint = 0;
     }
 }
@@ -154,8 +154,7 @@ void Box2DRevoluteJoint::setLowerAngle(float lowerAngle)
         return;
 
     mRevoluteJointDef.lowerAngle = lowerAngleRad;
-    if (mRevoluteJoint)
-        mRevoluteJoint->SetLimits(lowerAngleRad,mRevoluteJointDef.upperAngle);
+    updateJoint();
     emit lowerAngleChanged();
 }
 
@@ -176,9 +175,7 @@ void Box2DRevoluteJoint::setUpperAngle(float upperAngle)
         return;
 
     mRevoluteJointDef.upperAngle = upperAngleRad;
-    if (mRevoluteJoint)
-        mRevoluteJoint->SetLimits(mRevoluteJointDef.lowerAngle,
-                                  upperAngleRad);
+    updateJoint();
     emit upperAngleChanged();
 }
 
@@ -197,8 +194,7 @@ void Box2DRevoluteJoint::setMaxMotorTorque(float maxMotorTorque)
         return;
 
     mRevoluteJointDef.maxMotorTorque = maxMotorTorque;
-    if (mRevoluteJoint)
-        mRevoluteJoint->SetMaxMotorTorque(maxMotorTorque);
+    updateJoint();
     emit maxMotorTorqueChanged();
 }
 
@@ -218,8 +214,7 @@ void Box2DRevoluteJoint::setMotorSpeed(float motorSpeed)
         return;
 
     mRevoluteJointDef.motorSpeed = motorSpeedRad;
-    if (mRevoluteJoint)
-        mRevoluteJoint->SetMotorSpeed(motorSpeedRad);
+    updateJoint();
     emit motorSpeedChanged();
 }
 
@@ -238,8 +233,7 @@ void Box2DRevoluteJoint::setEnableLimit(bool enableLimit)
         return;
 
     mRevoluteJointDef.enableLimit = enableLimit;
-    if (mRevoluteJoint)
-        mRevoluteJoint->EnableLimit(enableLimit);
+    updateJoint();
     emit enableLimitChanged();
 }
 
@@ -258,8 +252,7 @@ void Box2DRevoluteJoint::setEnableMotor(bool enableMotor)
         return;
 
     mRevoluteJointDef.enableMotor = enableMotor;
-    if (mRevoluteJoint)
-        mRevoluteJoint->EnableMotor(enableMotor);
+    updateJoint();
     emit enableMotorChanged();
 }
 
@@ -319,6 +312,16 @@ void Box2DRevoluteJoint::createJoint()
     emit created();
 }
 
+void Box2DRevoluteJoint::updateJointFromDef()
+{
+    mRevoluteJoint->SetLimits(mRevoluteJointDef.lowerAngle,
+                              mRevoluteJointDef.upperAngle);
+    mRevoluteJoint->SetMaxMotorTorque(mRevoluteJointDef.maxMotorTorque);
+    mRevoluteJoint->SetMotorSpeed(mRevoluteJointDef.motorSpeed);
+    mRevoluteJoint->EnableLimit(mRevoluteJointDef.enableLimit);
+    mRevoluteJoint->EnableMotor(mRevoluteJointDef.enableMotor);
+}
+
 void Box2DRevoluteJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -327,7 +330,7 @@ void Box2DRevoluteJoint::cleanup(b2World *world)
     }
     if (mRevoluteJoint && bodyA() && bodyB()) {
         mRevoluteJoint->SetUserData(0);
-        world->DestroyJoint(mRevoluteJoint);
+        destroyJoint(world, mRevoluteJoint);
         mRevoluteJoint = 0;
     }
 }
@@ -61,7 +61,6 @@ The maxium length of the the rope joint
 */
 float Box2DRopeJoint::maxLength() const
 {
-    if(mRopeJoint) return mRopeJoint->GetMaxLength() * scaleRatio;
     return mRopeJointDef.maxLength * scaleRatio;
 }
 
@@ -71,8 +70,7 @@ void Box2DRopeJoint::setMaxLength(float _maxLength)
         return;
 
     mRopeJointDef.maxLength = _maxLength / scaleRatio;
-    if(mRopeJoint)
-        mRopeJoint->SetMaxLength(mRopeJointDef.maxLength);
+    updateJoint();
 
     emit maxLengthChanged();
 }
@@ -129,6 +127,11 @@ void Box2DRopeJoint::createJoint()
     emit created();
 }
 
+void Box2DRopeJoint::updateJointFromDef()
+{
+    mRopeJoint->SetMaxLength(mRopeJointDef.maxLength);
+}
+
 void Box2DRopeJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -137,7 +140,7 @@ void Box2DRopeJoint::cleanup(b2World *world)
     }
     if (mRopeJoint && bodyA() && bodyB()) {
         mRopeJoint->SetUserData(0);
-        world->DestroyJoint(mRopeJoint);
+        destroyJoint(world, mRopeJoint);
         mRopeJoint = 0;
     }
 }
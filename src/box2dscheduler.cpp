@@ -0,0 +1,158 @@
+/*
+ * box2dscheduler.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dscheduler.h"
+
+#include "box2dcoreworld.h"
+
+#include <QTimerEvent>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+
+/*!
+\class ScheduledStep
+Steps one shared world on the global thread pool.
+*/
+class ScheduledStep : public QRunnable
+{
+public:
+    ScheduledStep(Box2DCoreWorld *world, QSemaphore *done) :
+        mWorld(world),
+        mDone(done)
+    {}
+
+    void run()
+    {
+        mWorld->runStep(1);
+        mDone->release();
+    }
+
+private:
+    Box2DCoreWorld *mWorld;
+    QSemaphore *mDone;
+};
+
+/*!
+\class Box2DScheduler
+*/
+Box2DScheduler::Box2DScheduler(QObject *parent) :
+    QObject(parent),
+    mFrameTime(0)
+{
+}
+
+Box2DScheduler *Box2DScheduler::instance()
+{
+    static Box2DScheduler scheduler;
+    return &scheduler;
+}
+
+/**
+ * Adds a world to the stepped worlds. The scheduler ticks at the shortest
+ * frameTime of its worlds, and steps each world once its own frameTime has
+ * elapsed, so that worlds with a longer frameTime do not run too fast.
+ */
+void Box2DScheduler::registerWorld(Box2DCoreWorld *world)
+{
+    if (mWorlds.contains(world))
+        return;
+
+    mWorlds.append(world);
+    mElapsed.insert(world, 0);
+    updateTimer();
+}
+
+void Box2DScheduler::unregisterWorld(Box2DCoreWorld *world)
+{
+    mElapsed.remove(world);
+    if (mWorlds.removeOne(world))
+        updateTimer();
+}
+
+void Box2DScheduler::updateTimer()
+{
+    if (mWorlds.isEmpty()) {
+        mTimer.stop();
+        mFrameTime = 0;
+        return;
+    }
+
+    int frameTime = mWorlds.first()->frameTime();
+    foreach (Box2DCoreWorld *world, mWorlds)
+        frameTime = qMin(frameTime, world->frameTime());
+
+    if (frameTime != mFrameTime || !mTimer.isActive()) {
+        mFrameTime = frameTime;
+        mTimer.start(mFrameTime, this);
+    }
+}
+
+void Box2DScheduler::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == mTimer.timerId())
+        step();
+
+    QObject::timerEvent(event);
+}
+
+/**
+ * Steps the worlds whose frameTime has elapsed in parallel. The GUI thread
+ * steps the last one itself instead of only waiting for the others.
+ */
+void Box2DScheduler::step()
+{
+    // Adopt a changed frameTime from the next tick on
+    const int tick = mFrameTime;
+    updateTimer();
+
+    QList<Box2DCoreWorld*> worlds;
+    foreach (Box2DCoreWorld *world, mWorlds) {
+        int &elapsed = mElapsed[world];
+        elapsed += tick;
+        if (elapsed >= world->frameTime()) {
+            elapsed -= world->frameTime();
+            // A world is stepped at most once per tick, so time it cannot
+            // catch up on is dropped
+            elapsed = qMin(elapsed, world->frameTime());
+            worlds.append(world);
+        }
+    }
+    if (worlds.isEmpty())
+        return;
+
+    QSemaphore done;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (int i = 0; i < worlds.count() - 1; ++i)
+        pool->start(new ScheduledStep(worlds.at(i), &done));
+
+    worlds.last()->runStep(1);
+    done.acquire(worlds.count() - 1);
+
+    // Handlers of one world may destroy or unregister another
+    foreach (Box2DCoreWorld *world, worlds) {
+        if (mWorlds.contains(world))
+            world->finishStep();
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * box2dscheduler.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DSCHEDULER_H
+#define BOX2DSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QBasicTimer>
+
+class Box2DCoreWorld;
+
+/**
+ * Process-wide scheduler that steps all shared worlds on the same timer.
+ * The steps of the worlds run in parallel on the global thread pool, after
+ * which the bodies are synchronized and the signals are emitted on the GUI
+ * thread, one world after the other.
+ */
+class Box2DScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Box2DScheduler *instance();
+
+    void registerWorld(Box2DCoreWorld *world);
+    void unregisterWorld(Box2DCoreWorld *world);
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private:
+    explicit Box2DScheduler(QObject *parent = 0);
+
+    void updateTimer();
+    void step();
+
+    QList<Box2DCoreWorld*> mWorlds;
+    QHash<Box2DCoreWorld*, int> mElapsed;
+    QBasicTimer mTimer;
+    int mFrameTime;
+};
+
+#endif // BOX2DSCHEDULER_H
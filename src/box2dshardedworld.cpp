@@ -0,0 +1,540 @@
+/*
+ * box2dshardedworld.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dshardedworld.h"
+
+#include "box2dcoreworld.h"
+#include "box2dbody.h"
+
+#include <QTimerEvent>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <qmath.h>
+
+/*!
+\class ShardStep
+Steps a range of the shards of a sharded world on the global thread pool.
+*/
+class ShardStep : public QRunnable
+{
+public:
+    ShardStep(const QList<Box2DCoreWorld*> &shards, int begin, int end,
+              QSemaphore *done) :
+        mShards(shards),
+        mBegin(begin),
+        mEnd(end),
+        mDone(done)
+    {}
+
+    void run()
+    {
+        for (int i = mBegin; i < mEnd; ++i)
+            mShards.at(i)->runStep(1);
+        mDone->release();
+    }
+
+private:
+    const QList<Box2DCoreWorld*> &mShards;
+    int mBegin;
+    int mEnd;
+    QSemaphore *mDone;
+};
+
+/*!
+    \qmltype ShardedWorld
+    \instantiates Box2DShardedWorld
+    \inqmlmodule Box2D 1.1
+    \brief A large world split into tiles that are stepped in parallel.
+
+ShardedWorld is meant for open worlds with more bodies than a single World
+can step in time. Space is divided into tiles of \l tileSize, and each tile
+that has bodies in it is simulated by its own CoreWorld. The tiles are
+stepped in parallel on the global thread pool, after which the bodies are
+synchronized and the contact signals are emitted on the GUI thread.
+
+Bodies are declared inside of a ShardedWorld like inside of a World. Each
+body belongs to the tile its position is in. A body that gets within
+\l ghostMargin of another tile is mirrored into it as a ghost: a kinematic
+copy, or a static one for static bodies, that follows the body and that the
+bodies of that tile collide with. When a body crosses into another tile, it
+is moved to the CoreWorld of that tile.
+
+This trades some accuracy at the borders for speed:
+
+\list
+\li Ghosts do not respond to collisions, so a body only feels the
+    collision with a body from another tile after it has crossed over.
+\li No contact signals are emitted for collisions with ghosts.
+\li Ghosts keep the shape their body had when they were created.
+\li Joints only work between bodies of the same tile. Bodies with joints
+    stay in their tile.
+\endlist
+
+\code
+ShardedWorld {
+    tileSize: Qt.size(2048, 2048)
+    ghostMargin: 64
+
+    Repeater {
+        model: 10000
+        Body { ... }
+    }
+}
+\endcode
+*/
+
+/*!
+  \qmlproperty size ShardedWorld::tileSize
+  The size of a tile in pixels. Can only be changed before the world is
+  complete. 1024 by 1024 by default.
+*/
+
+/*!
+  \qmlproperty real ShardedWorld::ghostMargin
+  How close in pixels a body needs to get to another tile to be mirrored
+  into it. Should be at least the distance a body travels in one step. 32 by
+  default.
+*/
+
+/*!
+  \qmlproperty int ShardedWorld::shardCount
+  The number of tiles that currently have bodies in them. Read only.
+*/
+
+/*!
+\class Box2DShardedWorld
+*/
+Box2DShardedWorld::Box2DShardedWorld(QQuickItem *parent) :
+    QQuickItem(parent),
+    mIsRunning(true),
+    mTimeStep(1.0f / 60.0f),
+    mVelocityIterations(10),
+    mPositionIterations(10),
+    mFrameTime(1000 / 60),
+    mGravity(qreal(0), qreal(10)),
+    mTileSize(1024, 1024),
+    mGhostMargin(32)
+{
+}
+
+Box2DShardedWorld::~Box2DShardedWorld()
+{
+    mTimer.stop();
+
+    // The ghosts are destroyed along with the b2Worlds of the shards
+    foreach (Box2DBody *body, mEntries.keys())
+        disconnect(body, SIGNAL(destroyed()), this, SLOT(unregisterBody()));
+    mEntries.clear();
+
+    qDeleteAll(mShards);
+    mShards.clear();
+}
+
+void Box2DShardedWorld::setRunning(bool running)
+{
+    if (mIsRunning == running)
+        return;
+
+    mIsRunning = running;
+    emit runningChanged();
+
+    updateTimer();
+}
+
+void Box2DShardedWorld::setTimeStep(float timeStep)
+{
+    mTimeStep = timeStep;
+    foreach (Box2DCoreWorld *shard, mShards)
+        shard->setTimeStep(timeStep);
+}
+
+void Box2DShardedWorld::setVelocityIterations(int iterations)
+{
+    mVelocityIterations = iterations;
+    foreach (Box2DCoreWorld *shard, mShards)
+        shard->setVelocityIterations(iterations);
+}
+
+void Box2DShardedWorld::setPositionIterations(int iterations)
+{
+    mPositionIterations = iterations;
+    foreach (Box2DCoreWorld *shard, mShards)
+        shard->setPositionIterations(iterations);
+}
+
+void Box2DShardedWorld::setFrameTime(int frameTime)
+{
+    mFrameTime = frameTime;
+    updateTimer();
+}
+
+void Box2DShardedWorld::setGravity(const QPointF &gravity)
+{
+    if (mGravity == gravity)
+        return;
+
+    mGravity = gravity;
+    foreach (Box2DCoreWorld *shard, mShards)
+        shard->setGravity(gravity);
+
+    emit gravityChanged();
+}
+
+void Box2DShardedWorld::setTileSize(const QSizeF &tileSize)
+{
+    if (mTileSize == tileSize || tileSize.isEmpty())
+        return;
+
+    if (isComponentComplete()) {
+        qWarning("ShardedWorld: tileSize can not be changed once the world is complete");
+        return;
+    }
+
+    mTileSize = tileSize;
+    emit tileSizeChanged();
+}
+
+void Box2DShardedWorld::setGhostMargin(qreal ghostMargin)
+{
+    ghostMargin = qMax(qreal(0), ghostMargin);
+    if (mGhostMargin == ghostMargin)
+        return;
+
+    mGhostMargin = ghostMargin;
+    emit ghostMarginChanged();
+}
+
+/*!
+  \qmlmethod CoreWorld ShardedWorld::shardAt(point point)
+  Returns the CoreWorld simulating the tile at the given point, or null when
+  there are no bodies in that tile.
+*/
+Box2DCoreWorld *Box2DShardedWorld::shardAt(const QPointF &point) const
+{
+    return mShards.value(tileAt(b2Vec2(point.x() / scaleRatio,
+                                       -point.y() / scaleRatio)));
+}
+
+quint64 Box2DShardedWorld::tileKey(int column, int row)
+{
+    return (quint64(quint32(column)) << 32) | quint32(row);
+}
+
+quint64 Box2DShardedWorld::tileAt(const b2Vec2 &position) const
+{
+    return tileKey(qFloor(position.x * scaleRatio / mTileSize.width()),
+                   qFloor(-position.y * scaleRatio / mTileSize.height()));
+}
+
+/**
+ * Returns the shard of a tile, creating it when the tile has no bodies yet.
+ */
+Box2DCoreWorld *Box2DShardedWorld::shard(quint64 tile)
+{
+    Box2DCoreWorld *shard = mShards.value(tile);
+    if (!shard) {
+        shard = createShard();
+        mShards.insert(tile, shard);
+        emit shardCountChanged();
+    }
+    return shard;
+}
+
+Box2DCoreWorld *Box2DShardedWorld::createShard()
+{
+    Box2DCoreWorld *shard = new Box2DCoreWorld(this);
+
+    // The shards are stepped together by the sharded world
+    shard->setRunning(false);
+    shard->setTimeStep(mTimeStep);
+    shard->setVelocityIterations(mVelocityIterations);
+    shard->setPositionIterations(mPositionIterations);
+    shard->setGravity(mGravity);
+    shard->componentComplete();
+
+    return shard;
+}
+
+/**
+ * Adds a body to the shard of the tile it is in.
+ */
+void Box2DShardedWorld::registerBody(Box2DBody *body)
+{
+    if (mEntries.contains(body))
+        return;
+
+    Entry entry;
+    entry.tile = tileAt(b2Vec2(body->x() / scaleRatio, -body->y() / scaleRatio));
+    mEntries.insert(body, entry);
+    connect(body, SIGNAL(destroyed()), this, SLOT(unregisterBody()));
+
+    shard(entry.tile)->registerBody(body);
+}
+
+/**
+ * Removes the ghosts of a body that has been deleted. Its shard forgets
+ * about it by itself.
+ */
+void Box2DShardedWorld::unregisterBody()
+{
+    Box2DBody *body = static_cast<Box2DBody*>(sender());
+    Entry entry = mEntries.take(body);
+    removeGhosts(entry);
+}
+
+void Box2DShardedWorld::updateTimer()
+{
+    if (isComponentComplete() && mIsRunning)
+        mTimer.start(mFrameTime, this);
+    else
+        mTimer.stop();
+}
+
+void Box2DShardedWorld::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == mTimer.timerId())
+        step();
+
+    QQuickItem::timerEvent(event);
+}
+
+/**
+ * Steps all shards in parallel, then moves the bodies that crossed into
+ * another tile and updates the ghosts for the next step.
+ */
+void Box2DShardedWorld::step()
+{
+    if (mShards.isEmpty())
+        return;
+
+    const QList<Box2DCoreWorld*> shards = mShards.values();
+    const int shardCount = shards.count();
+    const int jobCount = qMin(shardCount, qMax(1, QThread::idealThreadCount()));
+
+    // The last range is stepped on this thread
+    QSemaphore done;
+    for (int job = 0; job < jobCount - 1; ++job) {
+        QThreadPool::globalInstance()->start(new ShardStep(shards,
+                                                           job * shardCount / jobCount,
+                                                           (job + 1) * shardCount / jobCount,
+                                                           &done));
+    }
+    for (int i = (jobCount - 1) * shardCount / jobCount; i < shardCount; ++i)
+        shards.at(i)->runStep(1);
+    done.acquire(jobCount - 1);
+
+    foreach (Box2DCoreWorld *shard, shards)
+        shard->finishStep();
+
+    migrateBodies();
+
+    QHash<Box2DBody*, Entry>::iterator it = mEntries.begin();
+    for (; it != mEntries.end(); ++it)
+        updateGhosts(it.key(), it.value());
+
+    removeEmptyShards();
+
+    emit stepped();
+}
+
+/**
+ * Moves the bodies that left their tile to the shard of their new tile.
+ * Static bodies and bodies with joints stay where they are.
+ */
+void Box2DShardedWorld::migrateBodies()
+{
+    QHash<Box2DBody*, Entry>::iterator it = mEntries.begin();
+    for (; it != mEntries.end(); ++it) {
+        Box2DBody *body = it.key();
+        Entry &entry = it.value();
+
+        b2Body *b = body->body();
+        if (!b || b->GetType() == b2_staticBody || b->GetJointList())
+            continue;
+
+        const quint64 tile = tileAt(b->GetPosition());
+        if (tile == entry.tile)
+            continue;
+
+        body->moveTo(shard(tile));
+        entry.tile = tile;
+    }
+}
+
+/**
+ * Mirrors the body into the tiles that are within the ghost margin of its
+ * fixtures, and removes the ghosts from the tiles it moved away from. Only
+ * tiles that already have a shard get ghosts.
+ */
+void Box2DShardedWorld::updateGhosts(Box2DBody *body, Entry &entry)
+{
+    b2Body *b = body->body();
+    if (!b || !b->IsActive() || !b->GetFixtureList()) {
+        removeGhosts(entry);
+        return;
+    }
+
+    b2AABB aabb = b->GetFixtureList()->GetAABB(0);
+    for (b2Fixture *f = b->GetFixtureList(); f; f = f->GetNext()) {
+        for (int32 i = 0; i < f->GetShape()->GetChildCount(); ++i)
+            aabb.Combine(f->GetAABB(i));
+    }
+
+    // The tiles covered by the box, in pixels with y pointing down
+    const qreal left = aabb.lowerBound.x * scaleRatio - mGhostMargin;
+    const qreal right = aabb.upperBound.x * scaleRatio + mGhostMargin;
+    const qreal top = -aabb.upperBound.y * scaleRatio - mGhostMargin;
+    const qreal bottom = -aabb.lowerBound.y * scaleRatio + mGhostMargin;
+    const int firstColumn = qFloor(left / mTileSize.width());
+    const int lastColumn = qFloor(right / mTileSize.width());
+    const int firstRow = qFloor(top / mTileSize.height());
+    const int lastRow = qFloor(bottom / mTileSize.height());
+
+    QList<Ghost> ghosts;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const quint64 tile = tileKey(column, row);
+            Box2DCoreWorld *shard = mShards.value(tile);
+            if (!shard || tile == entry.tile)
+                continue;
+
+            Ghost ghost;
+            ghost.tile = tile;
+            ghost.body = 0;
+            for (int i = 0; i < entry.ghosts.count(); ++i) {
+                if (entry.ghosts.at(i).tile == tile) {
+                    ghost.body = entry.ghosts.takeAt(i).body;
+                    break;
+                }
+            }
+
+            if (!ghost.body) {
+                b2BodyDef bodyDef;
+                bodyDef.type = b->GetType() == b2_staticBody ? b2_staticBody
+                                                             : b2_kinematicBody;
+                bodyDef.position = b->GetPosition();
+                bodyDef.angle = b->GetAngle();
+                ghost.body = shard->world()->CreateBody(&bodyDef);
+
+                for (b2Fixture *f = b->GetFixtureList(); f; f = f->GetNext()) {
+                    if (f->IsSensor())
+                        continue;
+
+                    b2FixtureDef fixtureDef;
+                    fixtureDef.shape = f->GetShape();
+                    fixtureDef.friction = f->GetFriction();
+                    fixtureDef.restitution = f->GetRestitution();
+                    fixtureDef.density = f->GetDensity();
+                    fixtureDef.filter = f->GetFilterData();
+                    ghost.body->CreateFixture(&fixtureDef);
+                }
+            } else if (!(ghost.body->GetPosition() == b->GetPosition())
+                       || ghost.body->GetAngle() != b->GetAngle()) {
+                ghost.body->SetTransform(b->GetPosition(), b->GetAngle());
+            }
+
+            // Kinematic ghosts move along with their body during the next step
+            if (ghost.body->GetType() == b2_kinematicBody) {
+                ghost.body->SetLinearVelocity(b->GetLinearVelocity());
+                ghost.body->SetAngularVelocity(b->GetAngularVelocity());
+            }
+
+            ghosts.append(ghost);
+        }
+    }
+
+    removeGhosts(entry);
+    entry.ghosts = ghosts;
+}
+
+/**
+ * Destroys the ghosts of a body, through their shards so that this is
+ * deferred while a shard is emitting its signals.
+ */
+void Box2DShardedWorld::removeGhosts(Entry &entry)
+{
+    foreach (const Ghost &ghost, entry.ghosts) {
+        if (Box2DCoreWorld *shard = mShards.value(ghost.tile))
+            shard->destroyBody(ghost.body);
+    }
+    entry.ghosts.clear();
+}
+
+/**
+ * Deletes the shards of tiles that no bodies and ghosts are left in.
+ */
+void Box2DShardedWorld::removeEmptyShards()
+{
+    bool removed = false;
+
+    QHash<quint64, Box2DCoreWorld*>::iterator it = mShards.begin();
+    while (it != mShards.end()) {
+        Box2DCoreWorld *shard = it.value();
+        if (shard->mBodies.isEmpty() && shard->mCommands.isEmpty()
+                && shard->world()->GetBodyCount() == 0) {
+            delete shard;
+            it = mShards.erase(it);
+            removed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (removed)
+        emit shardCountChanged();
+}
+
+void Box2DShardedWorld::componentComplete()
+{
+    QQuickItem::componentComplete();
+
+    QList<Box2DBody*> bodies;
+    collectBodies(this, bodies);
+    foreach (Box2DBody *body, bodies)
+        registerBody(body);
+
+    updateTimer();
+}
+
+void Box2DShardedWorld::itemChange(ItemChange change,
+                                   const ItemChangeData &value)
+{
+    if (isComponentComplete() && change == ItemChildAddedChange) {
+        if (Box2DBody *body = dynamic_cast<Box2DBody*>(value.item))
+            registerBody(body);
+    }
+
+    QQuickItem::itemChange(change, value);
+}
+
+void Box2DShardedWorld::collectBodies(QQuickItem *parent, QList<Box2DBody*> &list)
+{
+    foreach (QQuickItem *item, parent->childItems()) {
+        if (Box2DBody *body = dynamic_cast<Box2DBody*>(item))
+            list.append(body);
+        collectBodies(item, list);
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * box2dshardedworld.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DSHARDEDWORLD_H
+#define BOX2DSHARDEDWORLD_H
+
+#include <QQuickItem>
+#include <QList>
+#include <QHash>
+#include <QSizeF>
+#include <QBasicTimer>
+#include <Box2D.h>
+
+class Box2DBody;
+class Box2DCoreWorld;
+
+/**
+ * A world that is split into tiles, each simulated by its own CoreWorld.
+ * The tiles are stepped in parallel on the global thread pool. Bodies near
+ * the border of a tile are mirrored into the neighbouring tiles as ghosts,
+ * and move to another tile when they cross its border.
+ */
+class Box2DShardedWorld : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
+    Q_PROPERTY(float timeStep READ timeStep WRITE setTimeStep)
+    Q_PROPERTY(int velocityIterations READ velocityIterations WRITE setVelocityIterations)
+    Q_PROPERTY(int positionIterations READ positionIterations WRITE setPositionIterations)
+    Q_PROPERTY(int frameTime READ frameTime WRITE setFrameTime)
+    Q_PROPERTY(QPointF gravity READ gravity WRITE setGravity NOTIFY gravityChanged)
+    Q_PROPERTY(QSizeF tileSize READ tileSize WRITE setTileSize NOTIFY tileSizeChanged)
+    Q_PROPERTY(qreal ghostMargin READ ghostMargin WRITE setGhostMargin NOTIFY ghostMarginChanged)
+    Q_PROPERTY(int shardCount READ shardCount NOTIFY shardCountChanged)
+
+public:
+    explicit Box2DShardedWorld(QQuickItem *parent = 0);
+    ~Box2DShardedWorld();
+
+    bool isRunning() const { return mIsRunning; }
+    void setRunning(bool running);
+
+    float timeStep() const { return mTimeStep; }
+    void setTimeStep(float timeStep);
+
+    int velocityIterations() const { return mVelocityIterations; }
+    void setVelocityIterations(int iterations);
+
+    int positionIterations() const { return mPositionIterations; }
+    void setPositionIterations(int iterations);
+
+    int frameTime() const { return mFrameTime; }
+    void setFrameTime(int frameTime);
+
+    QPointF gravity() const { return mGravity; }
+    void setGravity(const QPointF &gravity);
+
+    /**
+     * The size of a tile in pixels. Can only be changed before the world is
+     * complete. 1024 by 1024 by default.
+     */
+    QSizeF tileSize() const { return mTileSize; }
+    void setTileSize(const QSizeF &tileSize);
+
+    /**
+     * How close in pixels a body needs to get to another tile to be mirrored
+     * into it. 32 by default.
+     */
+    qreal ghostMargin() const { return mGhostMargin; }
+    void setGhostMargin(qreal ghostMargin);
+
+    /**
+     * The number of tiles that currently have bodies in them.
+     */
+    int shardCount() const { return mShards.count(); }
+
+    Q_INVOKABLE Box2DCoreWorld *shardAt(const QPointF &point) const;
+
+    void registerBody(Box2DBody *body);
+
+    void componentComplete();
+
+signals:
+    void runningChanged();
+    void gravityChanged();
+    void tileSizeChanged();
+    void ghostMarginChanged();
+    void shardCountChanged();
+    void stepped();
+
+private slots:
+    void unregisterBody();
+
+protected:
+    void timerEvent(QTimerEvent *event);
+    void itemChange(ItemChange, const ItemChangeData &);
+
+private:
+    /**
+     * A kinematic or static copy of a body in a neighbouring tile. It has no
+     * user data, so it is invisible to the rest of the plugin.
+     */
+    struct Ghost {
+        quint64 tile;
+        b2Body *body;
+    };
+
+    /**
+     * The tile a body belongs to and its ghosts in other tiles.
+     */
+    struct Entry {
+        quint64 tile;
+        QList<Ghost> ghosts;
+    };
+
+    static quint64 tileKey(int column, int row);
+    quint64 tileAt(const b2Vec2 &position) const;
+    Box2DCoreWorld *shard(quint64 tile);
+    Box2DCoreWorld *createShard();
+
+    void updateTimer();
+    void step();
+    void migrateBodies();
+    void updateGhosts(Box2DBody *body, Entry &entry);
+    void removeGhosts(Entry &entry);
+    void removeEmptyShards();
+    void collectBodies(QQuickItem *parent, QList<Box2DBody*> &list);
+
+    bool mIsRunning;
+    float mTimeStep;
+    int mVelocityIterations;
+    int mPositionIterations;
+    int mFrameTime;
+    QPointF mGravity;
+    QSizeF mTileSize;
+    qreal mGhostMargin;
+    QBasicTimer mTimer;
+    QHash<quint64, Box2DCoreWorld*> mShards;
+    QHash<Box2DBody*, Entry> mEntries;
+};
+
+QML_DECLARE_TYPE(Box2DShardedWorld)
+
+#endif // BOX2DSHARDEDWORLD_H
@@ -99,8 +99,7 @@ void Box2DWeldJoint::setFrequencyHz(float frequencyHz)
         return;
 
     mWeldJointDef.frequencyHz = frequencyHz;
-    if (mWeldJoint)
-        mWeldJoint->SetFrequency(frequencyHz);
+    updateJoint();
     emit frequencyHzChanged();
 }
 
@@ -121,8 +120,7 @@ void Box2DWeldJoint::setDampingRatio(float dampingRatio)
         return;
 
     mWeldJointDef.dampingRatio = dampingRatio;
-    if (mWeldJoint)
-        mWeldJoint->SetDampingRatio(dampingRatio);
+    updateJoint();
     emit dampingRatioChanged();
 }
 
@@ -186,6 +184,12 @@ void Box2DWeldJoint::createJoint()
     emit created();
 }
 
+void Box2DWeldJoint::updateJointFromDef()
+{
+    mWeldJoint->SetFrequency(mWeldJointDef.frequencyHz);
+    mWeldJoint->SetDampingRatio(mWeldJointDef.dampingRatio);
+}
+
 void Box2DWeldJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -194,7 +198,7 @@ void Box2DWeldJoint::cleanup(b2World *world)
     }
     if (mWeldJoint && bodyA() && bodyB()) {
         mWeldJoint->SetUserData(0);
-        world->DestroyJoint(mWeldJoint);
+        destroyJoint(world, mWeldJoint);
         mWeldJoint = 0;
     }
 }
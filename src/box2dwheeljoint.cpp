@@ -74,7 +74,6 @@ Box2DWheelJoint::~Box2DWheelJoint()
 
 float Box2DWheelJoint::dampingRatio() const
 {
-    if(mWheelJoint) return mWheelJoint->GetSpringDampingRatio();
     return mWheelJointDef.dampingRatio;
 }
 
@@ -83,10 +82,8 @@ void Box2DWheelJoint::setDampingRatio(float _dampingRatio)
     if(qFuzzyCompare(dampingRatio(),_dampingRatio))
         return;
 
-    if(mWheelJoint)
-        mWheelJoint->SetSpringDampingRatio(_dampingRatio);
     mWheelJointDef.dampingRatio = _dampingRatio;
-
+    updateJoint();
     emit dampingRatioChanged();
 }
 
@@ -96,7 +93,6 @@ void Box2DWheelJoint::setDampingRatio(float _dampingRatio)
  */
 float Box2DWheelJoint::frequencyHz() const
 {
-    if(mWheelJoint) return mWheelJoint->GetSpringFrequencyHz();
     return mWheelJointDef.frequencyHz;
 }
 
@@ -105,9 +101,8 @@ void Box2DWheelJoint::setFrequencyHz(float _frequencyHz)
     if(qFuzzyCompare(frequencyHz(),_frequencyHz))
         return;
 
-    if(mWheelJoint)
-        mWheelJoint->SetSpringFrequencyHz(_frequencyHz);
     mWheelJointDef.frequencyHz = _frequencyHz;
+    updateJoint();
     emit frequencyHzChanged();
 }
 
@@ -118,8 +113,6 @@ void Box2DWheelJoint::setFrequencyHz(float _frequencyHz)
 
 float Box2DWheelJoint::maxMotorTorque() const
 {
-    if(mWheelJoint)
-        return mWheelJoint->GetMaxMotorTorque();
     return mWheelJointDef.maxMotorTorque;
 }
 
@@ -129,8 +122,7 @@ void Box2DWheelJoint::setMaxMotorTorque(float _maxMotorTorque)
         return;
 
     mWheelJointDef.maxMotorTorque = _maxMotorTorque;
-    if(mWheelJoint)
-        mWheelJoint->SetMaxMotorTorque(_maxMotorTorque);
+    updateJoint();
     emit maxMotorTorqueChanged();
 }
 /*!
@@ -139,8 +131,6 @@ void Box2DWheelJoint::setMaxMotorTorque(float _maxMotorTorque)
  */
 float Box2DWheelJoint::motorSpeed() const
 {
-    if(mWheelJoint)
-        return mWheelJoint->GetMotorSpeed() * b2_pi / 180;
     return -mWheelJointDef.motorSpeed * b2_pi / 180;
 }
 
@@ -151,8 +141,7 @@ void Box2DWheelJoint::setMotorSpeed(float _motorSpeed)
         return;
 
     mWheelJointDef.motorSpeed = motorSpeedRad;
-    if (mWheelJoint)
-        mWheelJoint->SetMotorSpeed(motorSpeedRad);
+    updateJoint();
     emit motorSpeedChanged();
 }
 /*!
@@ -162,8 +151,6 @@ void Box2DWheelJoint::setMotorSpeed(float _motorSpeed)
 
 bool Box2DWheelJoint::enableMotor() const
 {
-    if(mWheelJoint)
-        return mWheelJoint->IsMotorEnabled();
     return mWheelJointDef.enableMotor;
 }
 
@@ -173,8 +160,7 @@ void Box2DWheelJoint::setEnableMotor(bool _enableMotor)
         return;
 
     mWheelJointDef.enableMotor = _enableMotor;
-    if (mWheelJoint)
-        mWheelJoint->EnableMotor(_enableMotor);
+    updateJoint();
     emit enableMotorChanged();
 }
 /*!
@@ -263,6 +249,15 @@ void Box2DWheelJoint::createJoint()
     emit created();
 }
 
+void Box2DWheelJoint::updateJointFromDef()
+{
+    mWheelJoint->SetSpringDampingRatio(mWheelJointDef.dampingRatio);
+    mWheelJoint->SetSpringFrequencyHz(mWheelJointDef.frequencyHz);
+    mWheelJoint->SetMaxMotorTorque(mWheelJointDef.maxMotorTorque);
+    mWheelJoint->SetMotorSpeed(mWheelJointDef.motorSpeed);
+    mWheelJoint->EnableMotor(mWheelJointDef.enableMotor);
+}
+
 void Box2DWheelJoint::cleanup(b2World *world)
 {
     if(!world) {
@@ -271,7 +266,7 @@ void Box2DWheelJoint::cleanup(b2World *world)
     }
     if (mWheelJoint && bodyA() && bodyB()) {
         mWheelJoint->SetUserData(0);
-        world->DestroyJoint(mWheelJoint);
+        destroyJoint(world, mWheelJoint);
         mWheelJoint = 0;
     }
 }
@@ -28,61 +28,8 @@
 #include "box2dworld.h"
 
 #include "box2dbody.h"
-#include "box2dfixture.h"
-#include "box2djoint.h"
-#include "box2ddestructionlistener.h"
 
-#include <QTimerEvent>
-
-#include <Box2D.h>
-
-class ContactEvent
-{
-public:
-    enum Type {
-        BeginContact,
-        EndContact
-    };
-
-    Type type;
-    Box2DFixture *fixtureA;
-    Box2DFixture *fixtureB;
-};
-
-/*!
-\class ContactListener
-*/
-class ContactListener : public b2ContactListener
-{
-public:
-    void BeginContact(b2Contact *contact);
-    void EndContact(b2Contact *contact);
-
-    void removeEvent(int index) { mEvents.removeAt(index); }
-    void clearEvents() { mEvents.clear(); }
-    const QList<ContactEvent> &events() { return mEvents; }
-
-private:
-    QList<ContactEvent> mEvents;
-};
-
-void ContactListener::BeginContact(b2Contact *contact)
-{
-    ContactEvent event;
-    event.type = ContactEvent::BeginContact;
-    event.fixtureA = toBox2DFixture(contact->GetFixtureA());
-    event.fixtureB = toBox2DFixture(contact->GetFixtureB());
-    mEvents.append(event);
-}
-
-void ContactListener::EndContact(b2Contact *contact)
-{
-    ContactEvent event;
-    event.type = ContactEvent::EndContact;
-    event.fixtureA = toBox2DFixture(contact->GetFixtureA());
-    event.fixtureB = toBox2DFixture(contact->GetFixtureB());
-    mEvents.append(event);
-}
+#include <QQuickWindow>
 
 /*!
     \qmltype World
@@ -388,6 +335,321 @@ The amount of time each frame takes in milliseconds.
   By default it is 1000 / 60.
 */
 
+/*!
+  \qmlproperty bool World::threaded
+  When true, the world is stepped on a dedicated physics thread. After each
+  step the positions and angles of all bodies are written to a back buffer,
+  which the GUI thread swaps in and applies to the bodies. The GUI thread
+  never waits for the solver while applying transforms; when a step takes
+  longer than frameTime, the next one simply starts late.
+
+  The contact signals and stepped() are emitted on the GUI thread while no
+  step is running. Changes made to bodies, fixtures and joints while a step
+  runs or while those signals are emitted are queued, and applied together
+  in the order they were made once the signals have been emitted.
+
+  False by default.
+*/
+
+/*!
+  \qmlproperty bool World::shared
+  When true, the world is stepped by a process-wide scheduler together
+  with all other shared worlds, instead of by its own timer. On every tick
+  of the scheduler the steps of all shared worlds run in parallel on a
+  thread pool. Once all of them are done, the bodies are synchronized and
+  the signals are emitted on the GUI thread, one world after the other.
+
+  Use this for screens showing several independent simulations. The
+  scheduler ticks at the shortest frameTime of the shared worlds. A shared
+  world ignores steppingMode and threaded. False by default.
+*/
+
+/*!
+  \qmlproperty enumeration World::steppingMode
+  Selects what drives the stepping of the world.
+
+  \list
+  \li World.TimerStepping - a timer steps the world once every frameTime
+       milliseconds. This is the default.
+  \li World.RenderLoopStepping - the world is stepped after each frame
+       rendered by its window. The elapsed wall time is added to an
+       accumulator, and as many steps of timeStep seconds are taken as fit
+       in it, at most maxSubSteps per frame. Simulated time then follows
+       wall time exactly instead of drifting with the integer frameTime.
+  \endlist
+*/
+
+/*!
+  \qmlproperty int World::maxSubSteps
+  The maximum number of steps taken for one rendered frame when using
+  World.RenderLoopStepping. Caps the work done after a slow frame, so that
+  a slow step cannot cause ever more steps to be taken. 5 by default.
+*/
+
+/*!
+  \qmlproperty real World::droppedTime
+  The total simulated time, in seconds, that was skipped because a frame
+  would have needed more than maxSubSteps steps. Read only.
+*/
+
+/*!
+  \qmlproperty bool World::interpolating
+  When true, each Body is shown blended between its transforms before and
+  after the last step, using the fraction of a time step left in the
+  accumulator. This hides the judder caused by physics and display rates
+  that differ, for example when running the physics at 30 Hz on a 60 Hz
+  display by setting timeStep to 1 / 30. Bodies lag behind the simulation
+  by at most one step.
+
+  Only has an effect together with World.RenderLoopStepping. False by
+  default.
+*/
+
+/*!
+  \qmlproperty bool World::suspendWhenIdle
+  When true, the world stops stepping as soon as no awake dynamic or
+  kinematic body is left, and sets idle. While idle, no steps are taken and
+  no signals are emitted, which saves CPU and battery for scenes that come
+  to rest.
+
+  Stepping resumes when a body is woken up, moved, pushed or given a
+  velocity, when a body is added, and when gravity changes. Bodies woken
+  by other means, for example by a joint motor, are noticed within a
+  quarter of a second. False by default.
+*/
+
+/*!
+  \qmlproperty bool World::idle
+  True while stepping is suspended because all bodies are asleep. See
+  suspendWhenIdle. Read only.
+*/
+
+/*!
+  \qmlmethod World::wakeUp()
+  Resumes stepping of an idle world.
+*/
+
+/*!
+  \qmlproperty enumeration World::hiddenPolicy
+  Controls whether the world keeps stepping while its window is hidden,
+  minimized or not exposed, so that worlds in windows nobody looks at do
+  not take CPU time away from visible ones.
+
+  \list
+  \li World.KeepRunning - the world steps regardless of its window. This
+       is the default.
+  \li World.FreezeWhenHidden - stepping stops while the window is hidden
+       and continues where it left off when it is shown again.
+  \li World.CatchUpWhenHidden - stepping stops while the window is hidden.
+       When it is shown again, the time that passed is simulated in one
+       go, limited to maxCatchUpTime.
+  \endlist
+*/
+
+/*!
+  \qmlproperty real World::maxCatchUpTime
+  The maximum amount of time in seconds that is simulated when the window
+  is shown again, with World.CatchUpWhenHidden. 1 by default.
+*/
+
+/*!
+  \qmlproperty rect World::focusRect
+  The part of the world, usually the visible one, in which bodies get the
+  full update rate. Bodies whose origin lies outside of it are treated
+  according to outsideFocusPolicy, and go back to the full rate as soon as
+  they are inside again. An empty rectangle, the default, treats all bodies
+  as inside.
+
+  \code
+  World {
+      focusRect: Qt.rect(flickable.contentX - 100, flickable.contentY - 100,
+                         flickable.width + 200, flickable.height + 200)
+  }
+  \endcode
+*/
+
+/*!
+  \qmlproperty enumeration World::outsideFocusPolicy
+  Controls how bodies outside of the focusRect are updated.
+
+  \list
+  \li World.Deactivate - the bodies are deactivated, so that they are
+       neither simulated nor collide, and are reactivated with their
+       velocities intact when the focusRect covers them again. Bodies that
+       were inactive already are left alone. This is the default.
+  \li World.ReduceRate - the bodies are still simulated every step, only
+       their items are updated every reducedRateInterval steps. This saves
+       the cost of updating the items, not of solving the bodies, and suits
+       worlds where bodies outside of the view still have to interact.
+  \endlist
+
+  A b2World is always stepped as a whole, so there is no policy that
+  solves some of its bodies less often than others.
+*/
+
+/*!
+  \qmlproperty int World::reducedRateInterval
+  Every how many steps the items of bodies outside of the focusRect are
+  updated, with World.ReduceRate. The updates are spread over the steps.
+  4 by default.
+*/
+
+/*!
+  \qmlproperty int World::fullRateBodyCount
+  The number of bodies inside of the focusRect as of the last step. Read
+  only.
+*/
+
+/*!
+  \qmlproperty int World::reducedRateBodyCount
+  The number of bodies outside of the focusRect as of the last step, which
+  are updated at a reduced rate or deactivated. Read only.
+*/
+
+/*!
+  \qmlproperty int World::synchronizedBodyCount
+  The number of bodies whose position and rotation were updated by the last
+  step. Only bodies that moved since they were last updated are touched,
+  so static and sleeping bodies cost nothing. Read only.
+*/
+
+/*!
+  \qmlproperty bool World::renderOnlyTransforms
+  Whether each step only moves the bodies on screen, through a transform
+  applied by the scene graph, instead of updating their x, y and rotation
+  properties. This avoids the change signals and binding updates of
+  thousands of bodies. The properties are brought up to date every
+  propertyUpdateInterval steps or by commitTransforms(). False by default.
+  See CoreWorld::renderOnlyTransforms.
+*/
+
+/*!
+  \qmlproperty int World::propertyUpdateInterval
+  Every how many steps the x, y and rotation properties of the bodies are
+  updated, with renderOnlyTransforms. 0, the default, only updates them on
+  demand.
+*/
+
+/*!
+  \qmlmethod void World::commitTransforms()
+  Updates the x, y and rotation properties of all bodies to where they are
+  shown, with renderOnlyTransforms.
+*/
+
+/*!
+  \qmlproperty ArrayBuffer World::transforms
+  The bodies that moved in the last step, as 7 floats per body: the index
+  of the body, its x and y, rotation, linear velocity x and y, and angular
+  velocity. Read only. See CoreWorld::transforms.
+*/
+
+/*!
+  \qmlmethod Body World::bodyAt(int index)
+  Returns the body with the given index in transforms. Bodies are numbered
+  in the order they were added to the world, and the ones after a removed
+  body move up.
+*/
+
+/*!
+  \qmlproperty int World::rollbackFrames
+  How many steps the world keeps the state of, so that it can be rewound by
+  up to that many steps with rewind(). 0 by default, which keeps no history.
+*/
+
+/*!
+  \qmlmethod bool World::rewind(int steps)
+  Takes the bodies, contacts and joints back to how they were the given
+  number of steps ago, without recreating any item. Returns false when not
+  that many steps are kept. See CoreWorld::rewind().
+*/
+
+/*!
+  \qmlmethod void World::advance(int steps)
+  Steps the world right away by the given number of steps, for example to
+  catch up again after a rewind().
+*/
+
+/*!
+  \qmlproperty bool World::deterministic
+  Makes the world step to bit-identical results on every machine running
+  the same binary, as needed for lockstep multiplayer games. Contacts are
+  processed in the order in which their fixtures were created rather than
+  the order in which Box2D found them. False by default. See
+  CoreWorld::deterministic.
+*/
+
+/*!
+  \qmlproperty string World::stateHash
+  A 64-bit hash of the positions and velocities of all bodies after the
+  last step, as 16 hexadecimal digits. Only computed in deterministic mode.
+*/
+
+/*!
+  \qmlproperty bool World::asynchronous
+  Whether the bodies declared in the world are created on a worker thread
+  when the component is complete, so that a splash screen keeps animating
+  while a large level loads. Their definitions are collected on the GUI
+  thread, the b2World is populated on the worker thread and then swapped
+  in, emitting ready(). The world does not step until then. False by
+  default. See CoreWorld::asynchronous.
+
+  \code
+  World {
+      asynchronous: true
+      onReady: splash.visible = false
+  }
+  \endcode
+*/
+
+/*!
+  \qmlproperty bool World::loading
+  Whether an asynchronous world is still being built. Read only.
+*/
+
+/*!
+  \qmlsignal World::ready()
+  Emitted once the bodies declared in the world have been created, either
+  right when the component is complete or, for an asynchronous world, once
+  it has been built.
+*/
+
+/*!
+  \qmlmethod list<point> World::predictTrajectory(Body body, point impulse, int steps)
+  Predicts where the body goes over the given number of steps after the
+  impulse is applied to its center, against a frozen copy of the bodies in
+  its way. Returns the position of the body before and after each step, in
+  pixels. See CoreWorld::predictTrajectory().
+*/
+
+/*!
+  \qmlmethod int World::createBodies(LightBody prototype, positions)
+  Creates many bodies like the prototype in one call, one for each x and y
+  pair of the positions. Returns the handle of the first body. See
+  CoreWorld::createBodies().
+
+  \code
+  LightBody {
+      id: crate
+      bodyType: Body.Dynamic
+      lightFixtures: LightBox { width: 16; height: 16; density: 1 }
+  }
+
+  var positions = new Float32Array(2 * count);
+  ...
+  var first = world.createBodies(crate, positions.buffer);
+  \endcode
+*/
+
+/*!
+  \qmlmethod void World::destroyBodies(int handle, int count)
+  Destroys bodies created by createBodies().
+*/
+
+/*!
+  \qmlmethod point World::handlePosition(int handle)
+  The position of a body created by createBodies().
+*/
+
 /*!
   \variable QPointF::qpointf
   \qmlproperty qpointf World::gravity
@@ -399,164 +661,244 @@ The amount of time each frame takes in milliseconds.
 */
 Box2DWorld::Box2DWorld(QQuickItem *parent) :
     QQuickItem(parent),
-    mWorld(0),
-    mContactListener(new ContactListener),
-    mDestructionListener(new Box2DDestructionListener),
-    mTimeStep(1.0f / 60.0f),
-    mVelocityIterations(10),
-    mPositionIterations(10),
-    mFrameTime(1000 / 60),
-    mGravity(qreal(0), qreal(10)),
-    mIsRunning(true)
+    mCore(new Box2DCoreWorld(this)),
+    mSteppingMode(TimerStepping),
+    mMaxSubSteps(5),
+    mDroppedTime(0),
+    mAccumulator(0),
+    mWindow(0),
+    mInterpolating(false),
+    mHiddenPolicy(KeepRunning),
+    mMaxCatchUpTime(1),
+    mWindowHidden(false)
 {
-    connect(mDestructionListener, SIGNAL(fixtureDestroyed(Box2DFixture*)),
-            this, SLOT(fixtureDestroyed(Box2DFixture*)));
+    connect(mCore, SIGNAL(gravityChanged()), this, SIGNAL(gravityChanged()));
+    connect(mCore, SIGNAL(runningChanged()), this, SIGNAL(runningChanged()));
+    connect(mCore, SIGNAL(threadedChanged()), this, SIGNAL(threadedChanged()));
+    connect(mCore, SIGNAL(sharedChanged()), this, SIGNAL(sharedChanged()));
+    connect(mCore, SIGNAL(suspendWhenIdleChanged()), this, SIGNAL(suspendWhenIdleChanged()));
+    connect(mCore, SIGNAL(idleChanged()), this, SIGNAL(idleChanged()));
+    connect(mCore, SIGNAL(focusRectChanged()), this, SIGNAL(focusRectChanged()));
+    connect(mCore, SIGNAL(outsideFocusPolicyChanged()), this, SIGNAL(outsideFocusPolicyChanged()));
+    connect(mCore, SIGNAL(reducedRateIntervalChanged()), this, SIGNAL(reducedRateIntervalChanged()));
+    connect(mCore, SIGNAL(bodyCountsChanged()), this, SIGNAL(bodyCountsChanged()));
+    connect(mCore, SIGNAL(rollbackFramesChanged()), this, SIGNAL(rollbackFramesChanged()));
+    connect(mCore, SIGNAL(deterministicChanged()), this, SIGNAL(deterministicChanged()));
+    connect(mCore, SIGNAL(renderOnlyTransformsChanged()), this, SIGNAL(renderOnlyTransformsChanged()));
+    connect(mCore, SIGNAL(propertyUpdateIntervalChanged()), this, SIGNAL(propertyUpdateIntervalChanged()));
+    connect(mCore, SIGNAL(stepped()), this, SIGNAL(stepped()));
+    connect(mCore, SIGNAL(initialized()), this, SIGNAL(initialized()));
+    connect(mCore, SIGNAL(asynchronousChanged()), this, SIGNAL(asynchronousChanged()));
+    connect(mCore, SIGNAL(loadingChanged()), this, SIGNAL(loadingChanged()));
+    connect(mCore, SIGNAL(ready()), this, SIGNAL(ready()));
+
+    // The render loop needs a new frame whenever stepping resumes
+    connect(mCore, SIGNAL(runningChanged()), this, SLOT(updateStepping()));
+    connect(mCore, SIGNAL(sharedChanged()), this, SLOT(updateStepping()));
+    connect(mCore, SIGNAL(idleChanged()), this, SLOT(updateStepping()));
+    connect(mCore, SIGNAL(loadingChanged()), this, SLOT(updateStepping()));
 }
 
 Box2DWorld::~Box2DWorld()
 {
     // Bodies must be deleted before the world
-    foreach (Box2DBody *body, mBodies)
-    {
-        if(body->parent() == this)
-            delete body;
-        else
-            body->cleanup(this->world());
+    delete mCore;
+}
 
-    }
-    mBodies.clear();
+void Box2DWorld::setSteppingMode(SteppingMode steppingMode)
+{
+    if (mSteppingMode == steppingMode)
+        return;
+
+    mSteppingMode = steppingMode;
+    emit steppingModeChanged();
 
-    delete mWorld;
-    delete mContactListener;
-    delete mDestructionListener;
+    updateStepping();
 }
 
+void Box2DWorld::setMaxSubSteps(int maxSubSteps)
+{
+    if (mMaxSubSteps == maxSubSteps)
+        return;
 
-void Box2DWorld::setRunning(bool running)
+    mMaxSubSteps = maxSubSteps;
+    emit maxSubStepsChanged();
+}
+
+void Box2DWorld::setInterpolating(bool interpolating)
 {
-    if (mIsRunning == running)
+    if (mInterpolating == interpolating)
         return;
 
-    mIsRunning = running;
-    emit runningChanged();
+    mInterpolating = interpolating;
+    emit interpolatingChanged();
 
-    if (isComponentComplete()) {
-        if (running)
-            mTimer.start(mFrameTime, this);
-        else
-            mTimer.stop();
-    }
+    updateStepping();
 }
 
-void Box2DWorld::setGravity(const QPointF &gravity)
+void Box2DWorld::setHiddenPolicy(HiddenPolicy hiddenPolicy)
 {
-    if (mGravity == gravity)
+    if (mHiddenPolicy == hiddenPolicy)
         return;
 
-    mGravity = gravity;
-    if (mWorld)
-        mWorld->SetGravity(b2Vec2(gravity.x(), -gravity.y()));
+    mHiddenPolicy = hiddenPolicy;
+    emit hiddenPolicyChanged();
 
-    emit gravityChanged();
+    updateStepping();
 }
 
-void Box2DWorld::componentComplete()
+void Box2DWorld::setMaxCatchUpTime(qreal maxCatchUpTime)
 {
-    QQuickItem::componentComplete();
-
-    const b2Vec2 gravity(mGravity.x(), -mGravity.y());
+    if (mMaxCatchUpTime == maxCatchUpTime)
+        return;
 
-    mWorld = new b2World(gravity);
-    mWorld->SetContactListener(mContactListener);
-    mWorld->SetDestructionListener(mDestructionListener);
+    mMaxCatchUpTime = maxCatchUpTime;
+    emit maxCatchUpTimeChanged();
+}
 
-    QList<Box2DBody *> list;
-    GetAllBodies(this,list);
-    foreach(Box2DBody * body,list)
-    {
-        registerBody(body);
+bool Box2DWorld::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == mWindow) {
+        switch (event->type()) {
+        case QEvent::Expose:
+        case QEvent::Show:
+        case QEvent::Hide:
+        case QEvent::WindowStateChange:
+            updateWindowHidden();
+            break;
+        default:
+            break;
+        }
     }
 
-    emit initialized();
-    if (mIsRunning)
-        mTimer.start(mFrameTime, this);
-
+    return QQuickItem::eventFilter(watched, event);
 }
 
 /**
- * Registers a Box2D body with this world. When the world component is
- * complete, it will initialize the body.
+ * Tracks whether the window can be seen, and catches up on the time it was
+ * hidden when it is shown again.
  */
-void Box2DWorld::registerBody(Box2DBody *body)
+void Box2DWorld::updateWindowHidden()
 {
-    mBodies.append(body);
-    body->initialize(mWorld);
-    connect(body, SIGNAL(destroyed()), this, SLOT(unregisterBody()));
+    const bool hidden = mWindow && (!mWindow->isVisible()
+                                    || !mWindow->isExposed()
+                                    || mWindow->visibility() == QWindow::Minimized);
+    if (mWindowHidden == hidden)
+        return;
+
+    mWindowHidden = hidden;
+
+    if (mWindowHidden) {
+        mHiddenTimer.start();
+    } else if (mHiddenPolicy == CatchUpWhenHidden && mCore->world()
+               && mCore->isRunning() && !mCore->isIdle()) {
+        const qreal hiddenTime = qMin(mHiddenTimer.elapsed() / 1000.0, mMaxCatchUpTime);
+        const int steps = int(hiddenTime / mCore->timeStep());
+        if (steps > 0)
+            mCore->advance(steps);
+    }
+
+    updateStepping();
 }
 
 /**
- * Unregisters a Box2D body from this world. Called when a dynamically
- * created Box2D body has been deleted.
+ * Tells the core world how it is stepped, and restarts the render loop
+ * driven stepping when it is needed.
  */
-void Box2DWorld::unregisterBody()
+void Box2DWorld::updateStepping()
+{
+    const bool renderLoop = mSteppingMode == RenderLoopStepping;
+
+    mCore->setExternalStepping(renderLoop);
+    mCore->setInterpolating(renderLoop && mInterpolating);
+    mCore->setPaused(mWindowHidden && mHiddenPolicy != KeepRunning);
+
+    if (isComponentComplete() && renderLoopActive()) {
+        mAccumulator = 0;
+        mFrameTimer.invalidate();
+        if (mWindow)
+            mWindow->update();
+    }
+}
+
+bool Box2DWorld::renderLoopActive() const
 {
-    Box2DBody *body = static_cast<Box2DBody*>(sender());
-    mBodies.removeOne(body);
+    return mSteppingMode == RenderLoopStepping
+            && mCore->isRunning() && !mCore->isIdle() && !mCore->isShared()
+            && !(mWindowHidden && mHiddenPolicy != KeepRunning);
 }
 
-void Box2DWorld::fixtureDestroyed(Box2DFixture *fixture)
+void Box2DWorld::componentComplete()
 {
-    QList<ContactEvent> events = mContactListener->events();
-    for (int i = events.count() - 1; i >= 0; i--) {
-        if (events.at(i).fixtureA == fixture
-                || events.at(i).fixtureB == fixture)
-            mContactListener->removeEvent(i);
+    QQuickItem::componentComplete();
+
+    QList<Box2DBody *> list;
+    GetAllBodies(this,list);
+    foreach(Box2DBody * body,list)
+    {
+        registerBody(body);
     }
+
+    updateStepping();
+    mCore->componentComplete();
+    updateStepping();
 }
 
-void Box2DWorld::timerEvent(QTimerEvent *event)
+/**
+ * Called after each frame of the window when stepping with the render loop.
+ * Takes as many fixed time steps as fit in the time elapsed since the last
+ * frame, and schedules the next frame.
+ */
+void Box2DWorld::onFrameSwapped()
 {
-    if (event->timerId() == mTimer.timerId()) {
-        mWorld->Step(mTimeStep, mVelocityIterations, mPositionIterations);
-        foreach (Box2DBody *body, mBodies)
-            body->synchronize();
-
-        // Emit contact signals
-        foreach (const ContactEvent &event, mContactListener->events()) {
-            switch (event.type) {
-            case ContactEvent::BeginContact:
-                event.fixtureA->emitBeginContact(event.fixtureB);
-                event.fixtureB->emitBeginContact(event.fixtureA);
-                break;
-            case ContactEvent::EndContact:
-                event.fixtureA->emitEndContact(event.fixtureB);
-                event.fixtureB->emitEndContact(event.fixtureA);
-                break;
-            }
-        }
-        mContactListener->clearEvents();
+    if (!renderLoopActive() || !mCore->world())
+        return;
 
-        // Emit signals for the current state of the contacts
-        b2Contact *contact = mWorld->GetContactList();
-        while (contact) {
-            Box2DFixture *fixtureA = toBox2DFixture(contact->GetFixtureA());
-            Box2DFixture *fixtureB = toBox2DFixture(contact->GetFixtureB());
+    const qreal timeStep = mCore->timeStep();
 
-            fixtureA->emitContactChanged(fixtureB);
-            fixtureB->emitContactChanged(fixtureA);
+    if (mFrameTimer.isValid())
+        mAccumulator += mFrameTimer.nsecsElapsed() / 1000000000.0;
+    mFrameTimer.start();
 
-            contact = contact->GetNext();
+    // Keep accumulating while the previous step is still running
+    if (!mCore->isThreaded() || !mCore->isStepPending()) {
+        int steps = int(mAccumulator / timeStep);
+        if (steps > mMaxSubSteps) {
+            mAccumulator -= (steps - mMaxSubSteps) * timeStep;
+            mDroppedTime += (steps - mMaxSubSteps) * timeStep;
+            steps = mMaxSubSteps;
+            emit droppedTimeChanged();
         }
+        mAccumulator -= steps * timeStep;
 
-        emit stepped();
+        if (steps > 0)
+            mCore->advance(steps);
     }
 
-    QQuickItem::timerEvent(event);
+    if (mInterpolating)
+        mCore->interpolateBodies(qBound(qreal(0), mAccumulator / timeStep, qreal(1)));
+
+    if (mWindow)
+        mWindow->update();
 }
 
 void Box2DWorld::itemChange(ItemChange change,
                                 const ItemChangeData &value)
 {
+    if (change == ItemSceneChange) {
+        if (mWindow) {
+            disconnect(mWindow, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()));
+            mWindow->removeEventFilter(this);
+        }
+        mWindow = value.window;
+        if (mWindow) {
+            connect(mWindow, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()));
+            mWindow->installEventFilter(this);
+        }
+        updateWindowHidden();
+        updateStepping();
+    }
+
     if (isComponentComplete()) {
         if (change == ItemChildAddedChange) {
             QObject *child = value.item;
@@ -569,7 +911,6 @@ void Box2DWorld::itemChange(ItemChange change,
     QQuickItem::itemChange(change, value);
 }
 
-// Get all Box2DBodies attached to this world
 void Box2DWorld::GetAllBodies(QQuickItem *parent, QList<Box2DBody *> & list)
 {
     QList<QQuickItem *> children = parent->childItems();
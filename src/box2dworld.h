@@ -30,111 +30,285 @@
 
 #include <QQuickItem>
 #include <QList>
-#include <QBasicTimer>
+#include <QElapsedTimer>
 
-class Box2DBody;
-class Box2DFixture;
-class Box2DJoint;
-class ContactListener;
-class Box2DDestructionListener;
+#include "box2dcoreworld.h"
 
-class b2World;
+class Box2DBody;
+class Box2DLightBody;
 
-// TODO: Maybe turn this into a property of the world, though it can't be
-// changed dynamically.
-static const float scaleRatio = 32.0f; // 32 pixels in one meter
+class QQuickWindow;
 
 /**
- * Wrapper class around a Box2D world.
+ * Wrapper class around a Box2D world. Shows the simulation of a
+ * Box2DCoreWorld in a scene, and adds the stepping with the render loop and
+ * the handling of a hidden window.
  */
 class Box2DWorld : public QQuickItem
 {
     Q_OBJECT
+    Q_ENUMS(SteppingMode HiddenPolicy OutsideFocusPolicy)
     Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
     Q_PROPERTY(float timeStep READ timeStep WRITE setTimeStep)
     Q_PROPERTY(int velocityIterations READ velocityIterations WRITE setVelocityIterations)
     Q_PROPERTY(int positionIterations READ positionIterations WRITE setPositionIterations)
     Q_PROPERTY(int frameTime READ frameTime WRITE setFrameTime)
     Q_PROPERTY(QPointF gravity READ gravity WRITE setGravity NOTIFY gravityChanged)
+    Q_PROPERTY(bool threaded READ isThreaded WRITE setThreaded NOTIFY threadedChanged)
+    Q_PROPERTY(bool shared READ isShared WRITE setShared NOTIFY sharedChanged)
+    Q_PROPERTY(SteppingMode steppingMode READ steppingMode WRITE setSteppingMode NOTIFY steppingModeChanged)
+    Q_PROPERTY(int maxSubSteps READ maxSubSteps WRITE setMaxSubSteps NOTIFY maxSubStepsChanged)
+    Q_PROPERTY(qreal droppedTime READ droppedTime NOTIFY droppedTimeChanged)
+    Q_PROPERTY(bool interpolating READ isInterpolating WRITE setInterpolating NOTIFY interpolatingChanged)
+    Q_PROPERTY(bool suspendWhenIdle READ suspendWhenIdle WRITE setSuspendWhenIdle NOTIFY suspendWhenIdleChanged)
+    Q_PROPERTY(bool idle READ isIdle NOTIFY idleChanged)
+    Q_PROPERTY(HiddenPolicy hiddenPolicy READ hiddenPolicy WRITE setHiddenPolicy NOTIFY hiddenPolicyChanged)
+    Q_PROPERTY(qreal maxCatchUpTime READ maxCatchUpTime WRITE setMaxCatchUpTime NOTIFY maxCatchUpTimeChanged)
+    Q_PROPERTY(QRectF focusRect READ focusRect WRITE setFocusRect NOTIFY focusRectChanged)
+    Q_PROPERTY(OutsideFocusPolicy outsideFocusPolicy READ outsideFocusPolicy WRITE setOutsideFocusPolicy NOTIFY outsideFocusPolicyChanged)
+    Q_PROPERTY(int reducedRateInterval READ reducedRateInterval WRITE setReducedRateInterval NOTIFY reducedRateIntervalChanged)
+    Q_PROPERTY(int fullRateBodyCount READ fullRateBodyCount NOTIFY bodyCountsChanged)
+    Q_PROPERTY(int reducedRateBodyCount READ reducedRateBodyCount NOTIFY bodyCountsChanged)
+    Q_PROPERTY(int synchronizedBodyCount READ synchronizedBodyCount NOTIFY stepped)
+    Q_PROPERTY(bool renderOnlyTransforms READ renderOnlyTransforms WRITE setRenderOnlyTransforms NOTIFY renderOnlyTransformsChanged)
+    Q_PROPERTY(int propertyUpdateInterval READ propertyUpdateInterval WRITE setPropertyUpdateInterval NOTIFY propertyUpdateIntervalChanged)
+    Q_PROPERTY(QByteArray transforms READ transforms NOTIFY stepped)
+    Q_PROPERTY(int rollbackFrames READ rollbackFrames WRITE setRollbackFrames NOTIFY rollbackFramesChanged)
+    Q_PROPERTY(bool deterministic READ isDeterministic WRITE setDeterministic NOTIFY deterministicChanged)
+    Q_PROPERTY(bool asynchronous READ isAsynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(QString stateHash READ stateHashString NOTIFY stepped)
 
 public:
+    enum SteppingMode {
+        TimerStepping = 0,
+        RenderLoopStepping
+    };
+
+    enum HiddenPolicy {
+        KeepRunning = 0,
+        FreezeWhenHidden,
+        CatchUpWhenHidden
+    };
+
+    enum OutsideFocusPolicy {
+        ReduceRate = Box2DCoreWorld::ReduceRate,
+        Deactivate = Box2DCoreWorld::Deactivate
+    };
+
     explicit Box2DWorld(QQuickItem *parent = 0);
     ~Box2DWorld();
 
     /**
-     * The amount of time to step through each frame in seconds.
-     * By default it is 1 / 60.
+     * The simulation shown by this world.
      */
-    float timeStep() const { return mTimeStep; }
-    void setTimeStep(float timeStep) { mTimeStep = timeStep; }
+    Box2DCoreWorld *core() const { return mCore; }
 
-    bool isRunning() const { return mIsRunning; }
-    void setRunning(bool running);
+    float timeStep() const { return mCore->timeStep(); }
+    void setTimeStep(float timeStep) { mCore->setTimeStep(timeStep); }
+
+    bool isRunning() const { return mCore->isRunning(); }
+    void setRunning(bool running) { mCore->setRunning(running); }
 
-    /**
-     * The number of velocity iterations used to process one step.
-     * 10 by default.
-     */
     int velocityIterations() const
-    { return mVelocityIterations; }
+    { return mCore->velocityIterations(); }
 
     void setVelocityIterations(int iterations)
-    { mVelocityIterations = iterations; }
+    { mCore->setVelocityIterations(iterations); }
+
+    int positionIterations() const
+    { return mCore->positionIterations(); }
+
+    void setPositionIterations(int iterations)
+    { mCore->setPositionIterations(iterations); }
 
+    int frameTime() const { return mCore->frameTime(); }
+    void setFrameTime(int frameTime) { mCore->setFrameTime(frameTime); }
+
+    QPointF gravity() const { return mCore->gravity(); }
+    void setGravity(const QPointF &gravity) { mCore->setGravity(gravity); }
+
+    bool isThreaded() const { return mCore->isThreaded(); }
+    void setThreaded(bool threaded) { mCore->setThreaded(threaded); }
+
+    bool isShared() const { return mCore->isShared(); }
+    void setShared(bool shared) { mCore->setShared(shared); }
 
     /**
-     * The number of position iterations used to process one step.
-     * 10 by default.
+     * What drives the stepping of the world: a timer firing every frameTime
+     * milliseconds, or the frames of the window the world is shown in.
+     * TimerStepping by default.
      */
-    int positionIterations() const
-    { return mPositionIterations; }
+    SteppingMode steppingMode() const { return mSteppingMode; }
+    void setSteppingMode(SteppingMode steppingMode);
 
-    void setPositionIterations(int iterations)
-    { mPositionIterations = iterations; }
+    /**
+     * The maximum number of steps taken for a single rendered frame when
+     * stepping with the render loop. 5 by default.
+     */
+    int maxSubSteps() const { return mMaxSubSteps; }
+    void setMaxSubSteps(int maxSubSteps);
+
+    /**
+     * The total amount of simulated time in seconds that was dropped
+     * because a frame would have needed more than maxSubSteps steps.
+     */
+    qreal droppedTime() const { return mDroppedTime; }
+
+    /**
+     * Whether bodies are shown blended between the last two steps, based
+     * on the time left in the accumulator. Only has an effect when stepping
+     * with the render loop. False by default.
+     */
+    bool isInterpolating() const { return mInterpolating; }
+    void setInterpolating(bool interpolating);
+
+    bool suspendWhenIdle() const { return mCore->suspendWhenIdle(); }
+    void setSuspendWhenIdle(bool suspendWhenIdle)
+    { mCore->setSuspendWhenIdle(suspendWhenIdle); }
+
+    bool isIdle() const { return mCore->isIdle(); }
+
+    Q_INVOKABLE void wakeUp() { mCore->wakeUp(); }
+
+    /**
+     * What the world does while its window is hidden, minimized or not
+     * exposed. KeepRunning by default.
+     */
+    HiddenPolicy hiddenPolicy() const { return mHiddenPolicy; }
+    void setHiddenPolicy(HiddenPolicy hiddenPolicy);
 
     /**
-     * The amount of time each frame takes in milliseconds.
-     * By default it is 1000 / 60.
+     * The maximum amount of time in seconds that is simulated when the
+     * window is shown again, with the CatchUpWhenHidden policy. 1 by default.
      */
-    int frameTime() const { return mFrameTime; }
-    void setFrameTime(int frameTime) { mFrameTime = frameTime; }
+    qreal maxCatchUpTime() const { return mMaxCatchUpTime; }
+    void setMaxCatchUpTime(qreal maxCatchUpTime);
+
+    QRectF focusRect() const { return mCore->focusRect(); }
+    void setFocusRect(const QRectF &focusRect) { mCore->setFocusRect(focusRect); }
+
+    OutsideFocusPolicy outsideFocusPolicy() const
+    { return static_cast<OutsideFocusPolicy>(mCore->outsideFocusPolicy()); }
+
+    void setOutsideFocusPolicy(OutsideFocusPolicy outsideFocusPolicy)
+    { mCore->setOutsideFocusPolicy(static_cast<Box2DCoreWorld::OutsideFocusPolicy>(outsideFocusPolicy)); }
+
+    int reducedRateInterval() const { return mCore->reducedRateInterval(); }
+    void setReducedRateInterval(int reducedRateInterval)
+    { mCore->setReducedRateInterval(reducedRateInterval); }
+
+    int fullRateBodyCount() const { return mCore->fullRateBodyCount(); }
+    int reducedRateBodyCount() const { return mCore->reducedRateBodyCount(); }
+    int synchronizedBodyCount() const { return mCore->synchronizedBodyCount(); }
 
-    QPointF gravity() const { return mGravity; }
-    void setGravity(const QPointF &gravity);
+    bool renderOnlyTransforms() const { return mCore->renderOnlyTransforms(); }
+    void setRenderOnlyTransforms(bool renderOnlyTransforms)
+    { mCore->setRenderOnlyTransforms(renderOnlyTransforms); }
+
+    int propertyUpdateInterval() const { return mCore->propertyUpdateInterval(); }
+    void setPropertyUpdateInterval(int propertyUpdateInterval)
+    { mCore->setPropertyUpdateInterval(propertyUpdateInterval); }
+
+    Q_INVOKABLE void commitTransforms() { mCore->commitTransforms(); }
+
+    QByteArray transforms() const { return mCore->transforms(); }
+    Q_INVOKABLE Box2DBody *bodyAt(int index) const { return mCore->bodyAt(index); }
+    const float *transformData() const { return mCore->transformData(); }
+    int transformCount() const { return mCore->transformCount(); }
+
+    int rollbackFrames() const { return mCore->rollbackFrames(); }
+    void setRollbackFrames(int rollbackFrames)
+    { mCore->setRollbackFrames(rollbackFrames); }
+
+    Q_INVOKABLE bool rewind(int steps) { return mCore->rewind(steps); }
+    Q_INVOKABLE void advance(int steps) { mCore->advance(steps); }
+
+    bool isDeterministic() const { return mCore->isDeterministic(); }
+    void setDeterministic(bool deterministic)
+    { mCore->setDeterministic(deterministic); }
+
+    bool isAsynchronous() const { return mCore->isAsynchronous(); }
+    void setAsynchronous(bool asynchronous)
+    { mCore->setAsynchronous(asynchronous); }
+
+    bool isLoading() const { return mCore->isLoading(); }
+
+    quint64 stateHash() const { return mCore->stateHash(); }
+    QString stateHashString() const { return mCore->stateHashString(); }
 
     void componentComplete();
 
-    void registerBody(Box2DBody *body);
+    void registerBody(Box2DBody *body) { mCore->registerBody(body); }
 
-    b2World *world() const { return mWorld; }
+    b2World *world() const { return mCore->world(); }
+    b2World *cloneWorld() { return mCore->cloneWorld(); }
+
+    Q_INVOKABLE QVariantList predictTrajectory(Box2DBody *body,
+                                               const QPointF &impulse,
+                                               int steps)
+    { return mCore->predictTrajectory(body, impulse, steps); }
+
+    Q_INVOKABLE int createBodies(Box2DLightBody *prototype,
+                                 const QVariant &positions)
+    { return mCore->createBodies(prototype, positions); }
+    Q_INVOKABLE void destroyBodies(int handle, int count)
+    { mCore->destroyBodies(handle, count); }
+    Q_INVOKABLE QPointF handlePosition(int handle) const
+    { return mCore->handlePosition(handle); }
 
 private slots:
-    void unregisterBody();
-    void fixtureDestroyed(Box2DFixture *fixture);
+    void onFrameSwapped();
+    void updateStepping();
 
 signals:
     void gravityChanged();
     void runningChanged();
+    void threadedChanged();
+    void sharedChanged();
+    void steppingModeChanged();
+    void maxSubStepsChanged();
+    void droppedTimeChanged();
+    void interpolatingChanged();
+    void suspendWhenIdleChanged();
+    void idleChanged();
+    void hiddenPolicyChanged();
+    void maxCatchUpTimeChanged();
+    void focusRectChanged();
+    void outsideFocusPolicyChanged();
+    void reducedRateIntervalChanged();
+    void bodyCountsChanged();
+    void rollbackFramesChanged();
+    void deterministicChanged();
+    void renderOnlyTransformsChanged();
+    void propertyUpdateIntervalChanged();
     void stepped();
     void initialized();
+    void asynchronousChanged();
+    void loadingChanged();
+    void ready();
 
 protected:
-    void timerEvent(QTimerEvent *);
+    bool eventFilter(QObject *watched, QEvent *event);
     void itemChange(ItemChange, const ItemChangeData &);
     void GetAllBodies(QQuickItem * parent, QList<Box2DBody *> &list);
 
 private:
-    b2World *mWorld;
-    ContactListener *mContactListener;
-    Box2DDestructionListener *mDestructionListener;
-    float mTimeStep;
-    int mVelocityIterations;
-    int mPositionIterations;
-    int mFrameTime;
-    QPointF mGravity;
-    bool mIsRunning;
-    QBasicTimer mTimer;
-    QList<Box2DBody*> mBodies;
+    void updateWindowHidden();
+    bool renderLoopActive() const;
+
+    Box2DCoreWorld *mCore;
+    SteppingMode mSteppingMode;
+    int mMaxSubSteps;
+    qreal mDroppedTime;
+    qreal mAccumulator;
+    QElapsedTimer mFrameTimer;
+    QQuickWindow *mWindow;
+    bool mInterpolating;
+    HiddenPolicy mHiddenPolicy;
+    qreal mMaxCatchUpTime;
+    bool mWindowHidden;
+    QElapsedTimer mHiddenTimer;
 };
 
 QML_DECLARE_TYPE(Box2DWorld)
@@ -0,0 +1,458 @@
+/*
+ * box2dworldbatch.cpp
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "box2dworldbatch.h"
+
+#include "box2dcoreworld.h"
+#include "box2dbody.h"
+
+#include <QDebug>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+
+/*!
+\class BatchStep
+Steps a range of the worlds of a batch on the global thread pool.
+*/
+class BatchStep : public QRunnable
+{
+public:
+    BatchStep(const QList<Box2DCoreWorld*> &worlds, int begin, int end,
+              QSemaphore *done) :
+        mWorlds(worlds),
+        mBegin(begin),
+        mEnd(end),
+        mDone(done)
+    {}
+
+    void run()
+    {
+        for (int i = mBegin; i < mEnd; ++i)
+            mWorlds.at(i)->runStep(1);
+        mDone->release();
+    }
+
+private:
+    const QList<Box2DCoreWorld*> &mWorlds;
+    int mBegin;
+    int mEnd;
+    QSemaphore *mDone;
+};
+
+/*!
+    \qmltype WorldBatch
+    \instantiates Box2DWorldBatch
+    \inqmlmodule Box2D 1.1
+    \brief Steps many copies of the same world in lockstep.
+
+WorldBatch creates \l count copies of a CoreWorld from the \l scene
+component, and steps all of them together on the global thread pool. It is
+meant for running many environments at once, for example when training a
+controller, where stepping each world with its own timer would be far too
+slow.
+
+The copies do not step by themselves; they only advance when step() is
+called. Actions and observations are flat arrays of floats, in the units of
+the plugin: pixels, degrees and seconds, with y pointing down.
+
+\code
+WorldBatch {
+    id: batch
+    count: 256
+    actuators: ["cart"]
+    scene: Component {
+        CoreWorld {
+            Body { objectName: "cart"; bodyType: Body.Dynamic; ... }
+            Body { objectName: "pole"; bodyType: Body.Dynamic; ... }
+        }
+    }
+}
+
+// For each world: force x, force y and torque of the cart
+batch.applyActions(actions)
+batch.step()
+var observations = new Float32Array(batch.observations)
+\endcode
+*/
+
+/*!
+  \qmlproperty Component WorldBatch::scene
+  The component the worlds are created from. Its root object needs to be a
+  CoreWorld that is not asynchronous. Changing it recreates all worlds.
+*/
+
+/*!
+  \qmlproperty int WorldBatch::count
+  The number of worlds. Changing it recreates all worlds. 1 by default.
+*/
+
+/*!
+  \qmlproperty list<string> WorldBatch::actuators
+  The object names of the bodies in each world that the actions are applied
+  to.
+*/
+
+/*!
+  \qmlproperty int WorldBatch::bodyCount
+  The number of bodies in each world. Read only.
+*/
+
+/*!
+  \qmlproperty ArrayBuffer WorldBatch::observations
+  The state of all bodies of all worlds after the last step or reset, as
+  count * bodyCount * 6 floats. For each body, in the order the bodies were
+  added to their world: x, y, rotation, linear velocity x and y, and angular
+  velocity. Read only.
+*/
+
+/*!
+\class Box2DWorldBatch
+*/
+Box2DWorldBatch::Box2DWorldBatch(QObject *parent) :
+    QObject(parent),
+    mScene(0),
+    mCount(1),
+    mBodyCount(0),
+    mComponentComplete(false)
+{
+}
+
+Box2DWorldBatch::~Box2DWorldBatch()
+{
+    deleteWorlds();
+}
+
+void Box2DWorldBatch::setScene(QQmlComponent *scene)
+{
+    if (mScene == scene)
+        return;
+
+    mScene = scene;
+    emit sceneChanged();
+
+    createWorlds();
+}
+
+void Box2DWorldBatch::setCount(int count)
+{
+    count = qMax(0, count);
+    if (mCount == count)
+        return;
+
+    mCount = count;
+    emit countChanged();
+
+    createWorlds();
+}
+
+void Box2DWorldBatch::setActuators(const QStringList &actuators)
+{
+    if (mActuators == actuators)
+        return;
+
+    mActuators = actuators;
+    emit actuatorsChanged();
+
+    resolveActuators();
+}
+
+QByteArray Box2DWorldBatch::observations() const
+{
+    return QByteArray(reinterpret_cast<const char*>(mObservations.constData()),
+                      mObservations.count() * sizeof(float));
+}
+
+/*!
+  \qmlmethod CoreWorld WorldBatch::world(int index)
+  Returns one of the worlds, for example to show it or to inspect it.
+*/
+Box2DCoreWorld *Box2DWorldBatch::world(int index) const
+{
+    if (index < 0 || index >= mWorlds.count())
+        return 0;
+    return mWorlds.at(index);
+}
+
+/*!
+  \qmlmethod WorldBatch::step(int steps)
+  Advances all worlds by the given number of time steps, 1 by default. The
+  actions are applied before every step. Afterwards, the bodies are
+  synchronized, the contact signals of each world are emitted and the
+  observations are updated.
+*/
+void Box2DWorldBatch::step(int steps)
+{
+    if (mWorlds.isEmpty() || steps < 1)
+        return;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int worldCount = mWorlds.count();
+    const int jobCount = qMin(worldCount, qMax(1, QThread::idealThreadCount()));
+
+    for (int s = 0; s < steps; ++s) {
+        applyForces();
+
+        // The last range is stepped on this thread
+        QSemaphore done;
+        for (int job = 0; job < jobCount - 1; ++job) {
+            pool->start(new BatchStep(mWorlds,
+                                      job * worldCount / jobCount,
+                                      (job + 1) * worldCount / jobCount,
+                                      &done));
+        }
+        for (int i = (jobCount - 1) * worldCount / jobCount; i < worldCount; ++i)
+            mWorlds.at(i)->runStep(1);
+        done.acquire(jobCount - 1);
+    }
+
+    foreach (Box2DCoreWorld *world, mWorlds)
+        world->finishStep();
+
+    updateObservations();
+    emit observationsChanged();
+    emit stepped();
+}
+
+/*!
+  \qmlmethod WorldBatch::reset(list<int> worlds)
+  Puts the bodies of the given worlds back where they were when the worlds
+  were created, with their initial velocities. Resets all worlds when no
+  list is given.
+*/
+void Box2DWorldBatch::reset(const QVariantList &worlds)
+{
+    if (worlds.isEmpty()) {
+        for (int i = 0; i < mWorlds.count(); ++i)
+            resetWorld(i);
+    } else {
+        foreach (const QVariant &index, worlds)
+            resetWorld(index.toInt());
+    }
+
+    updateObservations();
+    emit observationsChanged();
+}
+
+/*!
+  \qmlmethod WorldBatch::applyActions(list<real> actions)
+  Sets the actions applied before each following step, as count *
+  actuators.length * 3 numbers. For each actuator of each world: the force
+  in x and y applied to the center of the body, and the torque. The actions
+  stay in effect until they are changed.
+*/
+void Box2DWorldBatch::applyActions(const QVariantList &actions)
+{
+    const int n = qMin(actions.count(), mActions.count());
+    for (int i = 0; i < n; ++i)
+        mActions[i] = actions.at(i).toFloat();
+}
+
+/**
+ * Sets the actions from an array of count floats, which should be
+ * count() * actuators().count() * ActionSize. Extra floats are ignored and
+ * missing ones leave the actions unchanged.
+ */
+void Box2DWorldBatch::applyActions(const float *actions, int count)
+{
+    const int n = qMin(count, mActions.count());
+    for (int i = 0; i < n; ++i)
+        mActions[i] = actions[i];
+}
+
+void Box2DWorldBatch::classBegin()
+{
+}
+
+void Box2DWorldBatch::componentComplete()
+{
+    mComponentComplete = true;
+    createWorlds();
+}
+
+void Box2DWorldBatch::createWorlds()
+{
+    deleteWorlds();
+
+    if (!mComponentComplete || !mScene)
+        return;
+
+    QQmlContext *context = mScene->creationContext();
+    if (!context)
+        context = qmlContext(this);
+
+    for (int i = 0; i < mCount; ++i) {
+        QObject *object = mScene->beginCreate(context);
+        Box2DCoreWorld *world = qobject_cast<Box2DCoreWorld*>(object);
+        if (!world) {
+            if (mScene->isError())
+                qWarning() << "WorldBatch:" << mScene->errorString();
+            else
+                qWarning() << "WorldBatch: the root of the scene is not a CoreWorld";
+            if (object) {
+                mScene->completeCreate();
+                delete object;
+            }
+            break;
+        }
+
+        world->setParent(this);
+        mScene->completeCreate();
+
+        // The initial states are taken from the b2Bodies right away
+        if (world->isLoading()) {
+            qWarning() << "WorldBatch: the scene cannot be an asynchronous world";
+            delete world;
+            break;
+        }
+
+        // The worlds are only stepped by the batch. This is set once the
+        // bindings of the scene were evaluated, so they cannot override it.
+        world->setRunning(false);
+        world->setThreaded(false);
+        world->setShared(false);
+
+        mWorlds.append(world);
+    }
+
+    mBodyCount = mWorlds.isEmpty() ? 0 : mWorlds.first()->mBodies.count();
+    foreach (Box2DCoreWorld *world, mWorlds)
+        mBodyCount = qMin(mBodyCount, world->mBodies.count());
+
+    // Remember the initial state of the bodies for reset()
+    mInitialStates.resize(mWorlds.count() * mBodyCount);
+    for (int w = 0; w < mWorlds.count(); ++w) {
+        for (int i = 0; i < mBodyCount; ++i) {
+            BodyState &state = mInitialStates[w * mBodyCount + i];
+            if (b2Body *b = mWorlds.at(w)->mBodies.at(i)->body()) {
+                state.position = b->GetPosition();
+                state.angle = b->GetAngle();
+                state.linearVelocity = b->GetLinearVelocity();
+                state.angularVelocity = b->GetAngularVelocity();
+            }
+        }
+    }
+
+    resolveActuators();
+    updateObservations();
+
+    emit worldsCreated();
+    emit observationsChanged();
+}
+
+void Box2DWorldBatch::deleteWorlds()
+{
+    qDeleteAll(mWorlds);
+    mWorlds.clear();
+    mActuatorBodies.clear();
+    mInitialStates.clear();
+    mActions.clear();
+    mObservations.clear();
+    mBodyCount = 0;
+}
+
+/**
+ * Looks up the bodies the actions apply to, by their object names.
+ */
+void Box2DWorldBatch::resolveActuators()
+{
+    const int actuatorCount = mActuators.count();
+    mActuatorBodies.fill(0, mWorlds.count() * actuatorCount);
+    mActions.fill(0, mWorlds.count() * actuatorCount * ActionSize);
+
+    for (int w = 0; w < mWorlds.count(); ++w) {
+        foreach (Box2DBody *body, mWorlds.at(w)->mBodies) {
+            const int a = mActuators.indexOf(body->objectName());
+            if (a != -1)
+                mActuatorBodies[w * actuatorCount + a] = body;
+        }
+    }
+}
+
+void Box2DWorldBatch::resetWorld(int index)
+{
+    if (index < 0 || index >= mWorlds.count())
+        return;
+
+    Box2DCoreWorld *world = mWorlds.at(index);
+    for (int i = 0; i < mBodyCount; ++i) {
+        Box2DBody *body = world->mBodies.at(i);
+        if (!body->body())
+            continue;
+
+        // The b2Body may only be moved once a running step is finished
+        const BodyState &state = mInitialStates.at(index * mBodyCount + i);
+        world->setBodyTransform(body, state.position, state.angle);
+        world->setBodyLinearVelocity(body, state.linearVelocity);
+        world->setBodyAngularVelocity(body, state.angularVelocity);
+        world->setBodyAwake(body, true);
+        body->synchronize(state.position, state.angle);
+    }
+    world->wakeUp();
+}
+
+void Box2DWorldBatch::applyForces()
+{
+    for (int i = 0; i < mActuatorBodies.count(); ++i) {
+        Box2DBody *body = mActuatorBodies.at(i);
+        if (!body || !body->body())
+            continue;
+
+        Box2DCoreWorld *world = body->coreWorld();
+        const float *action = mActions.constData() + i * ActionSize;
+        if (action[0] != 0 || action[1] != 0)
+            world->applyForceToCenter(body, b2Vec2(action[0] / scaleRatio,
+                                                   -action[1] / scaleRatio));
+        if (action[2] != 0)
+            world->applyTorque(body, action[2]);
+    }
+}
+
+void Box2DWorldBatch::updateObservations()
+{
+    mObservations.resize(mWorlds.count() * mBodyCount * ObservationSize);
+    float *observation = mObservations.data();
+
+    foreach (Box2DCoreWorld *world, mWorlds) {
+        for (int i = 0; i < mBodyCount; ++i) {
+            if (b2Body *b = world->mBodies.at(i)->body()) {
+                const b2Vec2 &position = b->GetPosition();
+                const b2Vec2 &velocity = b->GetLinearVelocity();
+                observation[0] = position.x * scaleRatio;
+                observation[1] = -position.y * scaleRatio;
+                observation[2] = -(b->GetAngle() * 180.0f) / b2_pi;
+                observation[3] = velocity.x * scaleRatio;
+                observation[4] = -velocity.y * scaleRatio;
+                observation[5] = -(b->GetAngularVelocity() * 180.0f) / b2_pi;
+            } else {
+                for (int k = 0; k < ObservationSize; ++k)
+                    observation[k] = 0;
+            }
+            observation += ObservationSize;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * box2dworldbatch.h
+ *
+ * This file is part of the Box2D QML plugin.
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software in
+ *    a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BOX2DWORLDBATCH_H
+#define BOX2DWORLDBATCH_H
+
+#include <QObject>
+#include <QQmlParserStatus>
+#include <QList>
+#include <QVector>
+#include <QStringList>
+#include <QVariant>
+#include <qqml.h>
+#include <Box2D.h>
+
+class Box2DBody;
+class Box2DCoreWorld;
+
+class QQmlComponent;
+
+/**
+ * A number of copies of the same world, created from one component and
+ * stepped in lockstep on the global thread pool. Meant for running many
+ * environments at once, for example to train a controller.
+ *
+ * Actions and observations are flat arrays of floats, in the units of the
+ * plugin: pixels, degrees and seconds, with y pointing down.
+ */
+class Box2DWorldBatch : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(QQmlComponent *scene READ scene WRITE setScene NOTIFY sceneChanged)
+    Q_PROPERTY(int count READ count WRITE setCount NOTIFY countChanged)
+    Q_PROPERTY(QStringList actuators READ actuators WRITE setActuators NOTIFY actuatorsChanged)
+    Q_PROPERTY(int bodyCount READ bodyCount NOTIFY worldsCreated)
+    Q_PROPERTY(QByteArray observations READ observations NOTIFY observationsChanged)
+
+public:
+    /**
+     * The number of floats per body in the observations: position x and y,
+     * rotation, linear velocity x and y and angular velocity.
+     */
+    static const int ObservationSize = 6;
+
+    /**
+     * The number of floats per actuator in the actions: force x and y,
+     * applied to the center of the body, and torque.
+     */
+    static const int ActionSize = 3;
+
+    explicit Box2DWorldBatch(QObject *parent = 0);
+    ~Box2DWorldBatch();
+
+    /**
+     * The component the worlds are created from. Its root object needs to
+     * be a CoreWorld.
+     */
+    QQmlComponent *scene() const { return mScene; }
+    void setScene(QQmlComponent *scene);
+
+    /**
+     * The number of worlds. 1 by default.
+     */
+    int count() const { return mCount; }
+    void setCount(int count);
+
+    /**
+     * The object names of the bodies that the actions are applied to, in
+     * the order of the actions of one world.
+     */
+    QStringList actuators() const { return mActuators; }
+    void setActuators(const QStringList &actuators);
+
+    /**
+     * The number of bodies in each world.
+     */
+    int bodyCount() const { return mBodyCount; }
+
+    QByteArray observations() const;
+
+    /**
+     * The observations of all worlds, count() * bodyCount() * ObservationSize
+     * floats. Valid until the next step or reset.
+     */
+    const float *observationData() const { return mObservations.constData(); }
+
+    Q_INVOKABLE Box2DCoreWorld *world(int index) const;
+
+    Q_INVOKABLE void step(int steps = 1);
+    Q_INVOKABLE void reset(const QVariantList &worlds = QVariantList());
+    Q_INVOKABLE void applyActions(const QVariantList &actions);
+
+    void applyActions(const float *actions, int count);
+
+    void classBegin();
+    void componentComplete();
+
+signals:
+    void sceneChanged();
+    void countChanged();
+    void actuatorsChanged();
+    void worldsCreated();
+    void observationsChanged();
+    void stepped();
+
+private:
+    /**
+     * The state of a body when its world was created, restored on reset.
+     */
+    struct BodyState {
+        b2Vec2 position;
+        float32 angle;
+        b2Vec2 linearVelocity;
+        float32 angularVelocity;
+    };
+
+    void createWorlds();
+    void deleteWorlds();
+    void resolveActuators();
+    void resetWorld(int index);
+    void applyForces();
+    void updateObservations();
+
+    QQmlComponent *mScene;
+    int mCount;
+    QStringList mActuators;
+    int mBodyCount;
+    bool mComponentComplete;
+    QList<Box2DCoreWorld*> mWorlds;
+    QVector<Box2DBody*> mActuatorBodies;
+    QVector<BodyState> mInitialStates;
+    QVector<float> mActions;
+    QVector<float> mObservations;
+};
+
+QML_DECLARE_TYPE(Box2DWorldBatch)
+
+#endif // BOX2DWORLDBATCH_H